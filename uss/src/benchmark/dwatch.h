@@ -1,14 +1,14 @@
-#ifndef DWATCH_INCLUDED
-#define DWATCH_INCLUDED
-
-void init_dwatch();
-
-double diff_dwatch();
-
-void print_dwatch();
-
-void print_dwatch(char *string);
-
-void print_dwatch(char *string, int print_diff_dwatch);
-
-#endif
+#ifndef DWATCH_INCLUDED
+#define DWATCH_INCLUDED
+
+void init_dwatch();
+
+double diff_dwatch();
+
+void print_dwatch();
+
+void print_dwatch(char *string);
+
+void print_dwatch(char *string, int print_diff_dwatch);
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * DISPATCH
+ *
+ * compares the quick dispatcher reading and handling one message
+ * per read() against draining the fifo with one read() and handling
+ * all messages as a batch (one pick_next per rq)
+ *
+ * a sender thread writes cleanup messages for random rqs into a pipe
+ * at a given rate (every millisecond rate/1000 messages at once, like
+ * jobs that finish a checkpoint together)
+ * the dispatcher does for each cleanup what handle_cleanup does and for
+ * each decision what pick_next does (lock rq, requeue leftmost, write a
+ * runon message)
+ *
+ * latency of a message: time between its write() and the end of the
+ * pick_next that handled it
+ *
+ * the send of pick_next resolves its fd either by lookup (address of
+ * the handle in a map under a mutex like get_address_of_handle, then
+ * fd of the address in a map under a mutex like get_fd_of_address)
+ * or takes the channel cached in the se (lookup vs cached)
+ * -> additionally the cost of one pick is measured without a sender
+ *
+ * syntax (needs USS_FIFO)
+ * uss_bench_dispatch [<msgs per second> ...]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "../daemon/uss_daemon.h"
+#include "../daemon/uss_rbtree.h"
+#include "../common/uss_fifo.h"
+
+#define BENCH_NOF_RQS 4
+#define BENCH_SES_PER_RQ 64
+#define BENCH_DURATION_MS 1000
+#define BENCH_NOF_HANDLES (BENCH_NOF_RQS * BENCH_SES_PER_RQ)
+#define BENCH_NOF_PICKS 1000000
+
+struct bench_rq
+{
+	pthread_mutex_t tree_mutex;
+	uss_rq_tree tree;
+	vector<uss_rq_node> nodes;
+	int curr;
+};
+
+static struct bench_rq rqs[BENCH_NOF_RQS];
+static int pipe_fds[2];
+static int rate;
+
+//lookup: handle -> address -> fd
+static pthread_mutex_t reg_mutex = PTHREAD_MUTEX_INITIALIZER;
+static map<int, struct uss_address> addr_table;
+static pthread_mutex_t fifo_mutex = PTHREAD_MUTEX_INITIALIZER;
+static map<struct uss_address, int> fifo_list;
+//cached: fd in the se
+static int channel_fd[BENCH_NOF_HANDLES];
+static int cached;
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * like handle_cleanup: update the se under the lock of its rq
+ */
+static void cleanup(struct uss_message *m)
+{
+	struct bench_rq *rq = &rqs[m->accelerator_index];
+	pthread_mutex_lock(&rq->tree_mutex);
+	rq->nodes[rq->curr].vruntime.time += 1;
+	pthread_mutex_unlock(&rq->tree_mutex);
+}
+
+/*
+ * like pick_next: requeue leftmost and send it a runon message
+ */
+static void pick(struct uss_message *m)
+{
+	struct bench_rq *rq = &rqs[m->accelerator_index];
+	pthread_mutex_lock(&rq->tree_mutex);
+	uss_rq_node *n = rq->tree.first();
+	rq->tree.update(n, uss_nanotime(n->vruntime.time + 1000));
+	rq->curr = n->handle % BENCH_SES_PER_RQ;
+	pthread_mutex_unlock(&rq->tree_mutex);
+
+	int fd;
+	if(cached) {fd = channel_fd[n->handle];}
+	else
+	{
+		pthread_mutex_lock(&reg_mutex);
+		struct uss_address addr = addr_table.find(n->handle)->second;
+		pthread_mutex_unlock(&reg_mutex);
+		pthread_mutex_lock(&fifo_mutex);
+		fd = fifo_list.find(addr)->second;
+		pthread_mutex_unlock(&fifo_mutex);
+	}
+
+	struct uss_message r;
+	memset(&r, 0, sizeof(struct uss_message));
+	r.message_type = USS_MESSAGE_RUNON;
+	r.accelerator_index = m->accelerator_index;
+	fifo_send(&r, fd);
+}
+
+static void* sender_thread(void *arg)
+{
+	int burst = (rate >= 1000) ? rate / 1000 : 1;
+	uint64_t period = (rate >= 1000) ? 1000000 : 1000000000 / rate;
+	uint64_t stop = now_ns() + (uint64_t)BENCH_DURATION_MS * 1000000;
+	unsigned int seed = 42;
+	struct uss_message m;
+	memset(&m, 0, sizeof(struct uss_message));
+	m.message_type = USS_MESSAGE_CLEANUP_DONE;
+
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while(now_ns() < stop)
+	{
+		for(int i = 0; i < burst; i++)
+		{
+			m.accelerator_index = rand_r(&seed) % BENCH_NOF_RQS;
+			m.init_ns = now_ns(); //carries the send time
+			fifo_send(&m, pipe_fds[1]);
+		}
+		next.tv_nsec += period;
+		while(next.tv_nsec >= 1000000000) {next.tv_nsec -= 1000000000; next.tv_sec++;}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+	//end marker
+	m.message_type = USS_MESSAGE_NOT_SET;
+	fifo_send(&m, pipe_fds[1]);
+	return NULL;
+}
+
+static void run(int batched)
+{
+	vector<uint64_t> latency;
+	long nof_reads = 0, nof_picks = 0;
+	struct uss_message m[USS_DISPATCHER_BATCH];
+	int done = 0;
+
+	pthread_t sender;
+	pthread_create(&sender, NULL, sender_thread, NULL);
+
+	while(!done)
+	{
+		int nof_messages;
+		if(batched)
+		{
+			nof_messages = fifo_batch_read(m, USS_DISPATCHER_BATCH, pipe_fds[0]) / sizeof(struct uss_message);
+		}
+		else
+		{
+			nof_messages = fifo_blocking_read(m, pipe_fds[0]) / sizeof(struct uss_message);
+		}
+		nof_reads++;
+
+		//apply cleanups and remember rqs to pick for
+		int topick[BENCH_NOF_RQS], nof_topick = 0;
+		for(int i = 0; i < nof_messages; i++)
+		{
+			if(m[i].message_type == USS_MESSAGE_NOT_SET) {done = 1; nof_messages = i; break;}
+			cleanup(&m[i]);
+			if(!batched) {pick(&m[i]); nof_picks++; continue;}
+
+			int j;
+			for(j = 0; j < nof_topick && topick[j] != m[i].accelerator_index; j++) {}
+			if(j == nof_topick) {topick[nof_topick++] = m[i].accelerator_index;}
+		}
+		for(int j = 0; j < nof_topick; j++)
+		{
+			struct uss_message p;
+			p.accelerator_index = topick[j];
+			pick(&p);
+			nof_picks++;
+		}
+
+		uint64_t handled = now_ns();
+		for(int i = 0; i < nof_messages; i++) {latency.push_back(handled - m[i].init_ns);}
+	}
+	pthread_join(sender, NULL);
+
+	sort(latency.begin(), latency.end());
+	uint64_t sum = 0;
+	for(size_t i = 0; i < latency.size(); i++) {sum += latency[i];}
+	size_t n = latency.size();
+
+	printf("%7i msgs/s | %-7s | %-6s | mean %8.1f us | p50 %8.1f us | p99 %8.1f us | %5.2f reads/msg | %5.2f picks/msg\n",
+			rate, batched ? "batch" : "single", cached ? "cached" : "lookup",
+			(double)sum / n / 1000, (double)latency[n / 2] / 1000, (double)latency[(n * 99) / 100] / 1000,
+			(double)nof_reads / n, (double)nof_picks / n);
+}
+
+/*
+ * cost of one pick (lock rq, requeue, resolve fd, write) without a sender
+ */
+static void run_picks()
+{
+	unsigned int seed = 42;
+	struct uss_message m;
+	memset(&m, 0, sizeof(struct uss_message));
+	uint64_t start = now_ns();
+	for(int i = 0; i < BENCH_NOF_PICKS; i++)
+	{
+		m.accelerator_index = rand_r(&seed) % BENCH_NOF_RQS;
+		pick(&m);
+	}
+	printf("pick_next | %-6s | %7.1f ns per pick\n", cached ? "cached" : "lookup",
+			(double)(now_ns() - start) / BENCH_NOF_PICKS);
+}
+
+int main(int argc, char** argv)
+{
+	if(pipe(pipe_fds) == -1) {printf("pipe failed\n"); return -1;}
+
+	for(int r = 0; r < BENCH_NOF_RQS; r++)
+	{
+		pthread_mutex_init(&rqs[r].tree_mutex, NULL);
+		rqs[r].nodes.resize(BENCH_SES_PER_RQ);
+		for(int h = 0; h < BENCH_SES_PER_RQ; h++)
+		{
+			int handle = r * BENCH_SES_PER_RQ + h;
+			rqs[r].nodes[h].vruntime = h;
+			rqs[r].nodes[h].handle = handle;
+			rqs[r].tree.insert(&rqs[r].nodes[h]);
+
+			//every client has a channel of its own
+			struct uss_address addr;
+			memset(&addr, 0, sizeof(struct uss_address));
+			addr.pid = 1000 + handle;
+			addr.fifo = ((long)addr.pid << 32) | 1;
+			int fd = open("/dev/null", O_WRONLY);
+			if(fd == -1) {printf("open /dev/null failed\n"); return -1;}
+			addr_table[handle] = addr;
+			fifo_list[addr] = fd;
+			channel_fd[handle] = fd;
+		}
+		rqs[r].curr = 0;
+	}
+
+	for(cached = 0; cached < 2; cached++) {run_picks();}
+
+	vector<int> rates;
+	if(argc > 1) {for(int i = 1; i < argc; i++) {rates.push_back(atoi(argv[i]));}}
+	else {rates.push_back(1000); rates.push_back(100000);}
+
+	for(size_t i = 0; i < rates.size(); i++)
+	{
+		rate = rates[i];
+		if(rate < 1) {printf("syntax: uss_bench_dispatch [<msgs per second> ...]\n"); return -1;}
+		cached = 0;
+		run(0);
+		run(1);
+		cached = 1;
+		run(1);
+	}
+	return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * HANDLES
+ *
+ * compares the old handle recycling (std::set of free handles under
+ * handle_mutex) against the generation tagged handle allocator with
+ * its lock-free free stack
+ *
+ * churn:   every thread keeps a window of live handles and frees the
+ *          oldest one for each new one it gets (registration thread
+ *          and daemon thread both touch the allocator)
+ * message: the dispatcher finds the handle of a message, either by its
+ *          address (map under reg_mutex) or by the echoed handle
+ *          (se slab checks the generation, stale ones are dropped)
+ *
+ * syntax
+ * uss_bench_handles [<nof threads> [<window>]]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+#include <map>
+
+#include "../daemon/uss_daemon.h"
+#include "../daemon/uss_handle.h"
+#include "../daemon/uss_slab.h"
+
+using namespace std;
+
+#define BENCH_DURATION_MS 1000
+#define BENCH_DEFAULT_THREADS 2
+#define BENCH_DEFAULT_WINDOW 256
+#define BENCH_NOF_MESSAGES 1000000
+
+static int nof_threads, window;
+static volatile int stop;
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/***************************************\
+* old: std::set under handle_mutex		*
+\***************************************/
+static set<int> reuse_handles;
+static int max_handle;
+static pthread_mutex_t handle_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int set_get()
+{
+	int h;
+	pthread_mutex_lock(&handle_mutex);
+	set<int>::iterator it = reuse_handles.begin();
+	if(it != reuse_handles.end()) {h = *it; reuse_handles.erase(it);}
+	else {h = ++max_handle;}
+	pthread_mutex_unlock(&handle_mutex);
+	return h;
+}
+
+static void set_put(int h)
+{
+	pthread_mutex_lock(&handle_mutex);
+	reuse_handles.insert(h);
+	pthread_mutex_unlock(&handle_mutex);
+}
+
+/***************************************\
+* new: uss_handle_allocator				*
+\***************************************/
+static uss_handle_allocator *handle_allocator;
+
+static int gen_get() {return handle_allocator->get();}
+static void gen_put(int h) {handle_allocator->put(h);}
+
+/***************************************\
+* churn									*
+\***************************************/
+struct churn_arg
+{
+	int (*get)();
+	void (*put)(int);
+	uint64_t ops;
+};
+
+static void* churn_thread(void *ptr)
+{
+	struct churn_arg *arg = (struct churn_arg*)ptr;
+	vector<int> live(window);
+	for(int i = 0; i < window; i++) {live[i] = arg->get();}
+
+	uint64_t ops = 0;
+	int oldest = 0;
+	while(!stop)
+	{
+		for(int k = 0; k < 64; k++)
+		{
+			arg->put(live[oldest]);
+			live[oldest] = arg->get();
+			oldest = (oldest + 1) % window;
+		}
+		ops += 64;
+	}
+	for(int i = 0; i < window; i++) {arg->put(live[i]);}
+	arg->ops = ops;
+	return NULL;
+}
+
+static void run_churn(const char *name, int (*get)(), void (*put)(int))
+{
+	vector<pthread_t> threads(nof_threads);
+	vector<struct churn_arg> args(nof_threads);
+	stop = 0;
+	for(int i = 0; i < nof_threads; i++)
+	{
+		args[i].get = get; args[i].put = put; args[i].ops = 0;
+		pthread_create(&threads[i], NULL, churn_thread, &args[i]);
+	}
+	struct timespec ts = {BENCH_DURATION_MS / 1000, (BENCH_DURATION_MS % 1000) * 1000000};
+	nanosleep(&ts, NULL);
+	stop = 1;
+
+	uint64_t ops = 0;
+	for(int i = 0; i < nof_threads; i++) {pthread_join(threads[i], NULL); ops += args[i].ops;}
+	printf("churn   | %-9s | %2i threads | %8.1f ns/(get+put) | %6.2f Mops/s\n", name, nof_threads,
+			(double)BENCH_DURATION_MS * 1000000 * nof_threads / ops, (double)ops / BENCH_DURATION_MS / 1000);
+}
+
+/***************************************\
+* message lookup						*
+\***************************************/
+struct bench_se
+{
+	int handle;
+	struct uss_address addr;
+};
+
+static void run_messages()
+{
+	map<struct uss_address, int> addr_table;
+	pthread_mutex_t reg_mutex = PTHREAD_MUTEX_INITIALIZER;
+	uss_slab<bench_se> *slab = new uss_slab<bench_se>();
+	uss_handle_allocator *a = new uss_handle_allocator();
+
+	//window live jobs, one message in 8 is a late one of a freed handle
+	vector<struct uss_address> addrs(window);
+	vector<int> handles(window), stale(window);
+	for(int i = 0; i < window; i++)
+	{
+		memset(&addrs[i], 0, sizeof(struct uss_address));
+		addrs[i].pid = 1000 + i;
+		stale[i] = a->get();
+		a->put(stale[i]);
+	}
+	for(int i = 0; i < window; i++)
+	{
+		handles[i] = a->get();
+		bench_se se; se.handle = handles[i]; se.addr = addrs[i];
+		slab->insert(handles[i], se);
+		addr_table[addrs[i]] = handles[i];
+	}
+
+	uint64_t found = 0;
+	uint64_t start = now_ns();
+	for(int i = 0; i < BENCH_NOF_MESSAGES; i++)
+	{
+		struct uss_address *addr = &addrs[(i * 7) % window];
+		pthread_mutex_lock(&reg_mutex);
+		map<struct uss_address, int>::iterator it = addr_table.find(*addr);
+		if(it != addr_table.end()) {found += it->second;}
+		pthread_mutex_unlock(&reg_mutex);
+	}
+	double addr_ns = (double)(now_ns() - start) / BENCH_NOF_MESSAGES;
+
+	uint64_t dropped = 0;
+	start = now_ns();
+	for(int i = 0; i < BENCH_NOF_MESSAGES; i++)
+	{
+		int j = (i * 7) % window;
+		int h = (i % 8 == 0) ? stale[j] : handles[j];
+		bench_se *se = slab->find(h);
+		if(se == NULL) {dropped++; continue;}
+		if(se->addr == addrs[j]) {found += h;}
+	}
+	double slab_ns = (double)(now_ns() - start) / BENCH_NOF_MESSAGES;
+
+	printf("message | address map + mutex | %6.1f ns/message\n", addr_ns);
+	printf("message | handle + slab       | %6.1f ns/message | %llu of %i stale dropped (check %llu)\n",
+			slab_ns, (unsigned long long)dropped, BENCH_NOF_MESSAGES, (unsigned long long)(found & 1));
+	delete slab;
+	delete a;
+}
+
+int main(int argc, char** argv)
+{
+	nof_threads = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_THREADS;
+	window = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_WINDOW;
+	if(nof_threads < 1 || window < 1) {printf("syntax: uss_bench_handles [<nof threads> [<window>]]\n"); return -1;}
+
+	handle_allocator = new uss_handle_allocator();
+	run_churn("set+mutex", set_get, set_put);
+	run_churn("lock-free", gen_get, gen_put);
+	delete handle_allocator;
+
+	run_messages();
+	return 0;
+}
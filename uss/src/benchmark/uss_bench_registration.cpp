@@ -0,0 +1,438 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * REGISTRATION
+ *
+ * registration storm: many client threads register at once (like a job
+ * array starting) and each waits for its response
+ *
+ * compares the two designs of the registration server
+ * thread: a detached thread per connection (fd handed over by a
+ *         mutex/cond rendezvous, at most 30 at once), each waits on the
+ *         cond of its pending entry until the scheduler decided on it,
+ *         the scheduler takes one registration per wakeup
+ * epoll:  a single nonblocking epoll server that queues complete requests,
+ *         the scheduler takes them as a batch and the server writes all
+ *         responses after one wakeup
+ * and registering all jobs with a single request (libuss_register_batch)
+ * batch:  one client sends the msais of all jobs over one connection
+ *         to the epoll server and reads all responses at once
+ *
+ * the scheduler spends BENCH_ADD_JOB_NS per registration (add_job)
+ *
+ * latency of a registration: connect() until the response has been read
+ *
+ * syntax
+ * uss_bench_registration [<nof jobs> ...]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "../common/uss_config.h"
+
+using namespace std;
+
+#define BENCH_SOCKET "/tmp/uss_bench_registration_socket"
+#define BENCH_ADD_JOB_NS 2000
+#define BENCH_MAX_THREADS 30
+#define BENCH_CLIENT_STACK (64*1024)
+
+struct bench_entry
+{
+	int fd;
+	int nof_msai;
+	int status;
+	pthread_mutex_t mtx;
+	pthread_cond_t cond;
+};
+
+static int listen_fd;
+static int new_reg_fd, finished_reg_fd;
+static pthread_mutex_t reg_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t reg_cond = PTHREAD_COND_INITIALIZER;
+static vector<struct bench_entry*> new_regs, finished_regs;
+static int nof_threads;
+static volatile int done;
+
+static pthread_barrier_t start_barrier;
+static vector<uint64_t> latency;
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void notify(int fd)
+{
+	uint64_t one = 1;
+	write(fd, &one, sizeof(uint64_t));
+}
+
+/*
+ * read or write exactly len bytes
+ */
+static void transfer(int fd, void *buf, size_t len, int do_write)
+{
+	size_t done = 0;
+	while(done < len)
+	{
+		ssize_t n = do_write ? write(fd, ((char*)buf) + done, len - done) : read(fd, ((char*)buf) + done, len - done);
+		if(n <= 0) {printf("transfer failed\n"); exit(1);}
+		done += n;
+	}
+}
+
+static void respond(struct bench_entry *e)
+{
+	vector<struct uss_registration_response> resp(e->nof_msai);
+	memset(&resp[0], 0, resp.size() * sizeof(struct uss_registration_response));
+	for(int i = 0; i < e->nof_msai; i++) {resp[i].check = USS_CONTROL_SCHED_ACCEPTED;}
+	fcntl(e->fd, F_SETFL, fcntl(e->fd, F_GETFL) & ~O_NONBLOCK);
+	transfer(e->fd, &resp[0], resp.size() * sizeof(struct uss_registration_response), 1);
+	close(e->fd);
+}
+
+/***************************************\
+* scheduler (main thread of daemon)		*
+\***************************************/
+static void* scheduler_thread(void *arg)
+{
+	int batched = *(int*)arg;
+	uint64_t counter;
+	while(!done)
+	{
+		//sleep until new registrations (like epoll in main loop)
+		if(read(new_reg_fd, &counter, sizeof(uint64_t)) == -1) {continue;}
+
+		while(1)
+		{
+			vector<struct bench_entry*> batch;
+			pthread_mutex_lock(&reg_mutex);
+			if(batched) {batch.swap(new_regs);}
+			else if(!new_regs.empty()) {batch.push_back(new_regs.front()); new_regs.erase(new_regs.begin());}
+			pthread_mutex_unlock(&reg_mutex);
+			if(batch.empty()) {break;}
+
+			for(size_t i = 0; i < batch.size(); i++)
+			{
+				uint64_t until = now_ns() + BENCH_ADD_JOB_NS * batch[i]->nof_msai;
+				while(now_ns() < until) {}
+			}
+
+			if(batched)
+			{
+				pthread_mutex_lock(&reg_mutex);
+				finished_regs.insert(finished_regs.end(), batch.begin(), batch.end());
+				pthread_mutex_unlock(&reg_mutex);
+				notify(finished_reg_fd);
+			}
+			else
+			{
+				pthread_mutex_lock(&batch[0]->mtx);
+				batch[0]->status = 1;
+				pthread_mutex_unlock(&batch[0]->mtx);
+				pthread_cond_signal(&batch[0]->cond);
+			}
+		}
+	}
+	return NULL;
+}
+
+/***************************************\
+* thread per connection					*
+\***************************************/
+struct bench_helper
+{
+	int fd;
+	int transported;
+	pthread_mutex_t mtx;
+	pthread_cond_t cond;
+};
+
+static void* connection_thread(void *arg)
+{
+	pthread_detach(pthread_self());
+	struct bench_helper *h = (struct bench_helper*)arg;
+	struct bench_entry e;
+	e.status = 0;
+	pthread_mutex_init(&e.mtx, NULL);
+	pthread_cond_init(&e.cond, NULL);
+
+	pthread_mutex_lock(&h->mtx);
+	e.fd = h->fd;
+	h->transported = 1;
+	pthread_mutex_unlock(&h->mtx);
+	pthread_cond_signal(&h->cond);
+
+	struct uss_registration_request request;
+	struct meta_sched_addr_info msai;
+	transfer(e.fd, &request, sizeof(struct uss_registration_request), 0);
+	transfer(e.fd, &msai, sizeof(struct meta_sched_addr_info), 0);
+	e.nof_msai = 1;
+
+	pthread_mutex_lock(&reg_mutex);
+	new_regs.push_back(&e);
+	pthread_mutex_unlock(&reg_mutex);
+	notify(new_reg_fd);
+
+	pthread_mutex_lock(&e.mtx);
+	while(e.status == 0) {pthread_cond_wait(&e.cond, &e.mtx);}
+	pthread_mutex_unlock(&e.mtx);
+	respond(&e);
+
+	pthread_mutex_lock(&reg_mutex);
+	nof_threads--;
+	pthread_mutex_unlock(&reg_mutex);
+	pthread_cond_signal(&reg_cond);
+	return NULL;
+}
+
+static void* thread_server(void *arg)
+{
+	struct bench_helper h;
+	pthread_mutex_init(&h.mtx, NULL);
+	pthread_cond_init(&h.cond, NULL);
+	pthread_t thread;
+	while(!done)
+	{
+		int fd = accept(listen_fd, NULL, NULL);
+		if(fd == -1) {continue;}
+
+		pthread_mutex_lock(&reg_mutex);
+		while(nof_threads >= BENCH_MAX_THREADS) {pthread_cond_wait(&reg_cond, &reg_mutex);}
+		nof_threads++;
+		pthread_mutex_unlock(&reg_mutex);
+
+		h.fd = fd;
+		h.transported = 0;
+		pthread_create(&thread, NULL, connection_thread, &h);
+		pthread_mutex_lock(&h.mtx);
+		while(h.transported == 0) {pthread_cond_wait(&h.cond, &h.mtx);}
+		pthread_mutex_unlock(&h.mtx);
+	}
+	return NULL;
+}
+
+/***************************************\
+* epoll server							*
+\***************************************/
+struct bench_connection
+{
+	ssize_t nof_br;
+	struct uss_registration_request request;
+	vector<struct meta_sched_addr_info> msais;
+};
+
+/*
+ * returns 1 once header and all msais have been read
+ */
+static int read_request(int fd, struct bench_connection *c)
+{
+	ssize_t header_len = sizeof(struct uss_registration_request);
+	char *buf;
+	ssize_t len;
+	if(c->nof_br < header_len)
+	{
+		buf = ((char*)&c->request) + c->nof_br;
+		len = header_len - c->nof_br;
+	}
+	else
+	{
+		buf = ((char*)&c->msais[0]) + c->nof_br - header_len;
+		len = header_len + c->msais.size() * sizeof(struct meta_sched_addr_info) - c->nof_br;
+	}
+	ssize_t n = read(fd, buf, len);
+	if(n > 0) {c->nof_br += n;}
+	if(c->nof_br == header_len) {c->msais.resize(c->request.nof_msai);}
+	return (c->nof_br == header_len + (ssize_t)(c->msais.size() * sizeof(struct meta_sched_addr_info)));
+}
+
+static void* epoll_server(void *arg)
+{
+	int epoll_fd = epoll_create1(0);
+	struct epoll_event ev, events[USS_REGISTRATION_BATCH];
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = EPOLLIN;
+	ev.data.fd = listen_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+	ev.data.fd = finished_reg_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, finished_reg_fd, &ev);
+
+	map<int, struct bench_connection> connections;
+	uint64_t counter;
+	while(!done)
+	{
+		int nof_events = epoll_wait(epoll_fd, events, USS_REGISTRATION_BATCH, 100);
+		vector<struct bench_entry*> complete;
+		for(int i = 0; i < nof_events; i++)
+		{
+			int fd = events[i].data.fd;
+			if(fd == listen_fd)
+			{
+				while((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK)) != -1)
+				{
+					ev.data.fd = fd;
+					epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+					connections[fd].nof_br = 0;
+				}
+			}
+			else if(fd == finished_reg_fd)
+			{
+				read(fd, &counter, sizeof(uint64_t));
+				vector<struct bench_entry*> finished;
+				pthread_mutex_lock(&reg_mutex);
+				finished.swap(finished_regs);
+				pthread_mutex_unlock(&reg_mutex);
+				for(size_t j = 0; j < finished.size(); j++) {respond(finished[j]); delete finished[j];}
+			}
+			else
+			{
+				if(read_request(fd, &connections[fd]))
+				{
+					epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+					struct bench_entry *e = new struct bench_entry;
+					e->fd = fd;
+					e->nof_msai = connections[fd].request.nof_msai;
+					connections.erase(fd);
+					complete.push_back(e);
+				}
+			}
+		}
+		if(!complete.empty())
+		{
+			pthread_mutex_lock(&reg_mutex);
+			new_regs.insert(new_regs.end(), complete.begin(), complete.end());
+			pthread_mutex_unlock(&reg_mutex);
+			notify(new_reg_fd);
+		}
+	}
+	close(epoll_fd);
+	return NULL;
+}
+
+/***************************************\
+* clients								*
+\***************************************/
+/*
+ * registers nof_msai jobs with one request
+ */
+static void* client_thread(void *arg)
+{
+	int nof_msai = *(int*)arg;
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(struct sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, BENCH_SOCKET, sizeof(addr.sun_path)-1);
+	struct uss_registration_request request;
+	request.nof_msai = nof_msai;
+	vector<struct meta_sched_addr_info> msais(nof_msai);
+	memset(&msais[0], 0, nof_msai * sizeof(struct meta_sched_addr_info));
+	vector<struct uss_registration_response> resp(nof_msai);
+
+	pthread_barrier_wait(&start_barrier);
+	uint64_t start = now_ns();
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(connect(fd, (struct sockaddr*)&addr, sizeof(struct sockaddr_un)) == -1) {printf("connect failed\n"); exit(1);}
+	transfer(fd, &request, sizeof(struct uss_registration_request), 1);
+	transfer(fd, &msais[0], nof_msai * sizeof(struct meta_sched_addr_info), 1);
+	transfer(fd, &resp[0], nof_msai * sizeof(struct uss_registration_response), 0);
+	uint64_t stop = now_ns();
+	close(fd);
+
+	pthread_mutex_lock(&reg_mutex);
+	latency.push_back(stop - start);
+	pthread_mutex_unlock(&reg_mutex);
+	return NULL;
+}
+
+enum bench_design
+{
+	BENCH_THREAD = 0,
+	BENCH_EPOLL = 1,
+	BENCH_BATCH = 2
+};
+
+static void run(int nof_jobs, int design)
+{
+	int epoll = (design != BENCH_THREAD);
+	//batch: a single client registers all jobs
+	int nof_clients = (design == BENCH_BATCH) ? 1 : nof_jobs;
+	int nof_msai = (design == BENCH_BATCH) ? nof_jobs : 1;
+	remove(BENCH_SOCKET);
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | (epoll ? SOCK_NONBLOCK : 0), 0);
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(struct sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, BENCH_SOCKET, sizeof(addr.sun_path)-1);
+	if(bind(listen_fd, (struct sockaddr*)&addr, sizeof(struct sockaddr_un)) == -1) {printf("bind failed\n"); exit(1);}
+	if(listen(listen_fd, SOMAXCONN) == -1) {printf("listen failed\n"); exit(1);}
+
+	new_reg_fd = eventfd(0, 0);
+	finished_reg_fd = eventfd(0, EFD_NONBLOCK);
+	done = 0;
+	nof_threads = 0;
+	latency.clear();
+
+	pthread_t server, scheduler;
+	pthread_create(&server, NULL, epoll ? epoll_server : thread_server, NULL);
+	pthread_create(&scheduler, NULL, scheduler_thread, &epoll);
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, BENCH_CLIENT_STACK);
+	pthread_barrier_init(&start_barrier, NULL, nof_clients + 1);
+	vector<pthread_t> clients(nof_clients);
+	for(int i = 0; i < nof_clients; i++)
+	{
+		if(pthread_create(&clients[i], &attr, client_thread, &nof_msai) != 0) {printf("pthread_create failed\n"); exit(1);}
+	}
+
+	pthread_barrier_wait(&start_barrier);
+	uint64_t start = now_ns();
+	for(int i = 0; i < nof_clients; i++) {pthread_join(clients[i], NULL);}
+	uint64_t stop = now_ns();
+
+	//wake up and stop server and scheduler
+	done = 1;
+	notify(new_reg_fd);
+	shutdown(listen_fd, SHUT_RDWR);
+	pthread_join(scheduler, NULL);
+	pthread_join(server, NULL);
+	close(listen_fd);
+	close(new_reg_fd);
+	close(finished_reg_fd);
+	pthread_barrier_destroy(&start_barrier);
+	pthread_attr_destroy(&attr);
+
+	sort(latency.begin(), latency.end());
+	size_t n = latency.size();
+	const char *name[] = {"thread", "epoll", "batch"};
+	printf("%5i jobs | %-6s | %9.0f regs/s | p50 %8.2f ms | p99 %8.2f ms\n",
+			nof_jobs, name[design],
+			(double)nof_jobs * 1000000000 / (stop - start),
+			(double)latency[n / 2] / 1000000, (double)latency[(n * 99) / 100] / 1000000);
+}
+
+int main(int argc, char** argv)
+{
+	vector<int> storms;
+	if(argc > 1) {for(int i = 1; i < argc; i++) {storms.push_back(atoi(argv[i]));}}
+	else {storms.push_back(200); storms.push_back(1000);}
+
+	for(size_t i = 0; i < storms.size(); i++)
+	{
+		if(storms[i] < 1 || storms[i] > USS_MAX_REGISTRATION_REQUEST) {printf("syntax: uss_bench_registration [<nof jobs> ...]\n"); return -1;}
+		run(storms[i], BENCH_THREAD);
+		run(storms[i], BENCH_EPOLL);
+		run(storms[i], BENCH_BATCH);
+	}
+	remove(BENCH_SOCKET);
+	return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * RQ LOCKING
+ *
+ * compares one global se lock (taken for every se access as
+ * the scheduler did before) against rq owned ses where only
+ * the tree_mutex of the touched rq is taken
+ *
+ * a number of dispatcher threads (like the quick dispatcher of
+ * the registration controller) pick the next se of a random rq
+ * while the tick thread (like the daemon thread) updates the
+ * runtime of the running se of every rq
+ *
+ * syntax
+ * uss_bench_rq_locking [<nof rqs> [<nof dispatcher threads>]]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+
+#include "../daemon/uss_daemon.h"
+
+#define BENCH_SES_PER_RQ 64
+#define BENCH_DURATION_MS 1000
+
+struct bench_se
+{
+	int handle;
+	int is_finished;
+	uint64_t vruntime;
+};
+
+struct bench_tree_entry
+{
+	uint64_t vruntime;
+	int handle;
+
+	bool operator< (const struct bench_tree_entry& other) const
+	{
+		return (this->vruntime < other.vruntime || (this->vruntime == other.vruntime && this->handle < other.handle));
+	}
+};
+
+struct bench_rq
+{
+	pthread_mutex_t tree_mutex;
+	set<bench_tree_entry> tree;
+	int curr;
+	char pad[64];
+};
+
+static int nof_rqs;
+static int nof_dispatchers;
+static int use_global_lock;
+static volatile int stop_flag;
+static pthread_mutex_t global_se_mutex = PTHREAD_MUTEX_INITIALIZER;
+static vector<bench_rq*> rqs;
+static vector<bench_se> ses;
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * pick the leftmost se of rq and requeue it at the end (like pick_next)
+ */
+static void pick(struct bench_rq *rq)
+{
+	pthread_mutex_lock(&rq->tree_mutex);
+	set<bench_tree_entry>::iterator it = rq->tree.begin();
+	if(it != rq->tree.end())
+	{
+		if(use_global_lock) {pthread_mutex_lock(&global_se_mutex);}
+		struct bench_se *se = &ses[(*it).handle];
+		if(se->is_finished == 0)
+		{
+			struct bench_tree_entry e = *it;
+			rq->tree.erase(it);
+			e.vruntime = ++se->vruntime;
+			rq->tree.insert(e);
+			rq->curr = e.handle;
+		}
+		if(use_global_lock) {pthread_mutex_unlock(&global_se_mutex);}
+	}
+	pthread_mutex_unlock(&rq->tree_mutex);
+}
+
+/*
+ * account some runtime to the running se of rq (like update_curr)
+ */
+static void tick(struct bench_rq *rq)
+{
+	pthread_mutex_lock(&rq->tree_mutex);
+	if(use_global_lock) {pthread_mutex_lock(&global_se_mutex);}
+	ses[rq->curr].vruntime += 1;
+	if(use_global_lock) {pthread_mutex_unlock(&global_se_mutex);}
+	pthread_mutex_unlock(&rq->tree_mutex);
+}
+
+static void* dispatcher_thread(void *arg)
+{
+	long *nof_ops = (long*)arg;
+	unsigned int seed = (unsigned int)(long)nof_ops;
+	while(stop_flag == 0)
+	{
+		pick(rqs[rand_r(&seed) % nof_rqs]);
+		(*nof_ops)++;
+	}
+	return NULL;
+}
+
+static void* tick_thread(void *arg)
+{
+	long *nof_ops = (long*)arg;
+	while(stop_flag == 0)
+	{
+		for(int i = 0; i < nof_rqs; i++) {tick(rqs[i]);}
+		(*nof_ops) += nof_rqs;
+	}
+	return NULL;
+}
+
+static void run(int global)
+{
+	use_global_lock = global;
+	stop_flag = 0;
+
+	//every thread counts in its own cacheline
+	vector<long> counters((nof_dispatchers + 1) * 16, 0);
+	vector<pthread_t> threads(nof_dispatchers + 1);
+
+	uint64_t start = now_ns();
+	for(int i = 0; i < nof_dispatchers; i++)
+	{
+		pthread_create(&threads[i], NULL, dispatcher_thread, &counters[i * 16]);
+	}
+	pthread_create(&threads[nof_dispatchers], NULL, tick_thread, &counters[nof_dispatchers * 16]);
+
+	usleep(BENCH_DURATION_MS * 1000);
+	stop_flag = 1;
+	for(int i = 0; i <= nof_dispatchers; i++) {pthread_join(threads[i], NULL);}
+	uint64_t stop = now_ns();
+
+	long picks = 0;
+	for(int i = 0; i < nof_dispatchers; i++) {picks += counters[i * 16];}
+	long ticks = counters[nof_dispatchers * 16];
+	double secs = (double)(stop - start) / 1000000000;
+
+	printf("%4i rqs | %2i dispatchers | %-13s | %10.0f picks/s | %10.0f ticks/s\n",
+			nof_rqs, nof_dispatchers, global ? "global lock" : "rq owned ses",
+			picks / secs, ticks / secs);
+}
+
+int main(int argc, char** argv)
+{
+	nof_rqs = (argc > 1) ? atoi(argv[1]) : 16;
+	nof_dispatchers = (argc > 2) ? atoi(argv[2]) : 4;
+	if(nof_rqs < 1 || nof_dispatchers < 1)
+	{
+		printf("syntax: uss_bench_rq_locking [<nof rqs> [<nof dispatcher threads>]]\n");
+		return -1;
+	}
+
+	ses.resize(nof_rqs * BENCH_SES_PER_RQ);
+	for(int i = 0; i < nof_rqs; i++)
+	{
+		struct bench_rq *rq = new bench_rq;
+		pthread_mutex_init(&rq->tree_mutex, NULL);
+		for(int j = 0; j < BENCH_SES_PER_RQ; j++)
+		{
+			int h = i * BENCH_SES_PER_RQ + j;
+			ses[h].handle = h;
+			ses[h].is_finished = 0;
+			ses[h].vruntime = j;
+			struct bench_tree_entry e;
+			e.vruntime = j;
+			e.handle = h;
+			rq->tree.insert(e);
+		}
+		rq->curr = i * BENCH_SES_PER_RQ;
+		rqs.push_back(rq);
+	}
+
+	run(1);
+	run(0);
+	return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * RQ TREE
+ *
+ * compares the old std::set rq tree against the intrusive
+ * red-black tree with cached leftmost node
+ *
+ * two operations are measured like the scheduler does them:
+ * tick:    pick_next reads the leftmost handle and update_runtime
+ *          requeues it with a slightly larger vruntime
+ * migrate: move_to_rq removes a random handle and enqueues it again
+ *
+ * syntax
+ * uss_bench_rq_tree [<nof handles> ...]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+#include "../daemon/uss_daemon.h"
+#include "../daemon/uss_rbtree.h"
+
+#define BENCH_NOF_OPS 1000000
+
+struct bench_tree_entry
+{
+	uss_nanotime vruntime;
+	int handle;
+
+	bench_tree_entry(uss_nanotime t, int h)
+	{
+		vruntime = t;
+		handle = h;
+	}
+
+	bool operator< (const struct bench_tree_entry& other) const
+	{
+		return (this->vruntime < other.vruntime || (this->vruntime == other.vruntime && this->handle < other.handle));
+	}
+};
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void print_result(int nof_handles, const char *tree, const char *op, uint64_t start, uint64_t stop, long sum)
+{
+	printf("%8i handles | %-11s | %-7s | %8.1f ns/op (%ld)\n", nof_handles, tree, op,
+			(double)(stop - start) / BENCH_NOF_OPS, sum % 10);
+}
+
+static void run(int nof_handles)
+{
+	//vruntime of each handle like the se would keep it
+	vector<uint64_t> vruntime(nof_handles);
+	vector<int> random_handles(BENCH_NOF_OPS);
+	srand(42);
+	for(int h = 0; h < nof_handles; h++) {vruntime[h] = (uint64_t)rand() * 1000;}
+	for(int i = 0; i < BENCH_NOF_OPS; i++) {random_handles[i] = rand() % nof_handles;}
+
+	uint64_t start, stop;
+	long sum;
+
+	//
+	//std::set
+	//
+	{
+		set<bench_tree_entry> tree;
+		vector<uint64_t> v = vruntime;
+		for(int h = 0; h < nof_handles; h++) {tree.insert(bench_tree_entry(v[h], h));}
+
+		sum = 0;
+		start = now_ns();
+		for(int i = 0; i < BENCH_NOF_OPS; i++)
+		{
+			int h = (*tree.begin()).handle;
+			tree.erase(bench_tree_entry(v[h], h));
+			v[h] += 1000;
+			tree.insert(bench_tree_entry(v[h], h));
+			sum += h;
+		}
+		stop = now_ns();
+		print_result(nof_handles, "std::set", "tick", start, stop, sum);
+
+		sum = 0;
+		start = now_ns();
+		for(int i = 0; i < BENCH_NOF_OPS; i++)
+		{
+			int h = random_handles[i];
+			tree.erase(bench_tree_entry(v[h], h));
+			v[h] = v[(*tree.begin()).handle] + 50000000;
+			tree.insert(bench_tree_entry(v[h], h));
+			sum += h;
+		}
+		stop = now_ns();
+		print_result(nof_handles, "std::set", "migrate", start, stop, sum);
+	}
+
+	//
+	//intrusive rq tree (nodes are embedded like in uss_se)
+	//
+	{
+		uss_rq_tree tree;
+		vector<uss_rq_node> nodes(nof_handles);
+		for(int h = 0; h < nof_handles; h++)
+		{
+			nodes[h].vruntime = vruntime[h];
+			nodes[h].handle = h;
+			tree.insert(&nodes[h]);
+		}
+
+		sum = 0;
+		start = now_ns();
+		for(int i = 0; i < BENCH_NOF_OPS; i++)
+		{
+			uss_rq_node *n = tree.first();
+			tree.update(n, uss_nanotime(n->vruntime.time + 1000));
+			sum += n->handle;
+		}
+		stop = now_ns();
+		print_result(nof_handles, "uss_rq_tree", "tick", start, stop, sum);
+
+		sum = 0;
+		start = now_ns();
+		for(int i = 0; i < BENCH_NOF_OPS; i++)
+		{
+			uss_rq_node *n = &nodes[random_handles[i]];
+			tree.erase(n);
+			n->vruntime = tree.first()->vruntime.time + 50000000;
+			tree.insert(n);
+			sum += n->handle;
+		}
+		stop = now_ns();
+		print_result(nof_handles, "uss_rq_tree", "migrate", start, stop, sum);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc > 1)
+	{
+		for(int i = 1; i < argc; i++) {run(atoi(argv[i]));}
+	}
+	else
+	{
+		run(1000);
+		run(10000);
+		run(100000);
+	}
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * SE TABLE
+ *
+ * compares the dispatch latency of the old std::map se table
+ * against the handle indexed se slab
+ *
+ * a dispatch is simulated like pick_next does it:
+ * walk the vruntime ordered rq tree from the left and look up
+ * the se of each entry until an idle one is found
+ *
+ * syntax
+ * uss_bench_se_table [<nof handles> ...]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+#include "../daemon/uss_daemon.h"
+#include "../daemon/uss_slab.h"
+
+//number of handles in tree that are not idle and are skipped by each dispatch
+#define BENCH_NOF_BUSY 16
+#define BENCH_NOF_DISPATCHES 200000
+
+/*
+ * an entry of about the size of uss_se
+ */
+struct bench_se
+{
+	int handle;
+	int execution_mode;
+	int is_finished;
+	uss_nanotime vruntime;
+	struct meta_sched_addr_info msai;
+};
+
+struct bench_tree_entry
+{
+	uint64_t vruntime;
+	int handle;
+
+	bool operator< (const struct bench_tree_entry& other) const
+	{
+		return (this->vruntime < other.vruntime || (this->vruntime == other.vruntime && this->handle < other.handle));
+	}
+};
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * rotates the picked handle to the end of the tree
+ * (like a finished slice would) and returns the number of lookups
+ */
+template <class LOOKUP>
+static long dispatch(set<bench_tree_entry> &tree, LOOKUP lookup, uint64_t *clock)
+{
+	long nof_lookups = 0;
+	set<bench_tree_entry>::iterator it = tree.begin();
+	for(; it != tree.end(); it++)
+	{
+		struct bench_se *se = lookup((*it).handle);
+		nof_lookups++;
+		if(se->is_finished == 0 && se->execution_mode == 0)
+		{
+			struct bench_tree_entry e = *it;
+			tree.erase(it);
+			e.vruntime = ++(*clock);
+			tree.insert(e);
+			se->vruntime.time = e.vruntime;
+			break;
+		}
+	}
+	return nof_lookups;
+}
+
+struct map_lookup
+{
+	map<int, bench_se> *m;
+	struct bench_se* operator() (int h) {return &(*m->find(h)).second;}
+};
+
+struct slab_lookup
+{
+	uss_slab<bench_se> *s;
+	struct bench_se* operator() (int h) {return s->find(h);}
+};
+
+static void run(int nof_handles)
+{
+	map<int, bench_se> *m = new map<int, bench_se>();
+	uss_slab<bench_se> *s = new uss_slab<bench_se>();
+	set<bench_tree_entry> tree_map, tree_slab;
+
+	//registration order is random with respect to vruntime
+	vector<int> handles;
+	for(int h = 1; h <= nof_handles; h++) {handles.push_back(h);}
+	srand(42);
+	random_shuffle(handles.begin(), handles.end());
+
+	for(int i = 0; i < nof_handles; i++)
+	{
+		//(value-initialized: zeroed, then the constructor of vruntime)
+		struct bench_se se = bench_se();
+		se.handle = handles[i];
+		se.execution_mode = (i % (nof_handles / BENCH_NOF_BUSY) == 0) ? 4 : 0;
+		se.vruntime.time = i;
+		m->insert(make_pair(se.handle, se));
+		s->insert(se.handle, se);
+
+		struct bench_tree_entry e;
+		e.vruntime = i;
+		e.handle = se.handle;
+		tree_map.insert(e);
+		tree_slab.insert(e);
+	}
+
+	uint64_t clock, start, stop;
+	long lookups;
+
+	map_lookup ml; ml.m = m;
+	clock = nof_handles; lookups = 0;
+	start = now_ns();
+	for(int i = 0; i < BENCH_NOF_DISPATCHES; i++) {lookups += dispatch(tree_map, ml, &clock);}
+	stop = now_ns();
+	printf("%8i handles | std::map | %8.1f ns/dispatch | %6.1f ns/lookup\n", nof_handles,
+			(double)(stop - start) / BENCH_NOF_DISPATCHES, (double)(stop - start) / lookups);
+
+	slab_lookup sl; sl.s = s;
+	clock = nof_handles; lookups = 0;
+	start = now_ns();
+	for(int i = 0; i < BENCH_NOF_DISPATCHES; i++) {lookups += dispatch(tree_slab, sl, &clock);}
+	stop = now_ns();
+	printf("%8i handles | uss_slab | %8.1f ns/dispatch | %6.1f ns/lookup\n", nof_handles,
+			(double)(stop - start) / BENCH_NOF_DISPATCHES, (double)(stop - start) / lookups);
+
+	delete m;
+	delete s;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc > 1)
+	{
+		for(int i = 1; i < argc; i++) {run(atoi(argv[i]));}
+	}
+	else
+	{
+		run(1000);
+		run(10000);
+		run(100000);
+	}
+	return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * user space scheduler (USS)
+ * benchmarks
+ * TRANSPORT
+ *
+ * compares the round trip latency of the daemon <-> client transports
+ * FIFO:      a pipe per direction (fifo_send / fifo_blocking_read)
+ * RTSIG:     sigqueue + signalfd per direction
+ * SHM futex: shared memory rings, receiver sleeps on futex if ring is empty
+ * SHM spin:  shared memory rings, receiver polls the ring (no syscalls)
+ *
+ * a forked child plays the client: it echoes every message it gets
+ * additionally the cost of an empty nonblocking read is measured
+ * (what the library does on every checkpoint via update_run_on)
+ *
+ * syntax
+ * uss_bench_transport [<round trips>]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/signalfd.h>
+#include <vector>
+#include <algorithm>
+
+#include "../common/uss_config.h"
+#include "../common/uss_fifo.h"
+#include "../common/uss_shm.h"
+#include "../common/uss_tools.h"
+
+using namespace std;
+
+#define BENCH_DEFAULT_ROUND_TRIPS 100000
+#define BENCH_NOF_POLLS 1000000
+
+static int nof_round_trips;
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void print_result(const char *name, vector<uint64_t> &rtt, double poll_ns)
+{
+	sort(rtt.begin(), rtt.end());
+	uint64_t sum = 0;
+	for(size_t i = 0; i < rtt.size(); i++) {sum += rtt[i];}
+	size_t n = rtt.size();
+
+	printf("%-9s | rtt mean %7.2f us | p50 %7.2f us | p99 %7.2f us | empty poll %7.1f ns\n",
+			name, (double)sum / n / 1000, (double)rtt[n / 2] / 1000, (double)rtt[(n * 99) / 100] / 1000,
+			poll_ns);
+}
+
+/***************************************\
+* FIFO									*
+\***************************************/
+static void run_fifo()
+{
+	int to_client[2], to_daemon[2];
+	if(pipe(to_client) == -1 || pipe(to_daemon) == -1) {dexit("pipe");}
+	struct uss_message m;
+	memset(&m, 0, sizeof(struct uss_message));
+
+	pid_t pid = fork();
+	if(pid == 0)
+	{
+		for(int i = 0; i < nof_round_trips; i++)
+		{
+			fifo_blocking_read(&m, to_client[0]);
+			fifo_send(&m, to_daemon[1]);
+		}
+		_exit(0); //no flush of the inherited stdout buffer
+	}
+
+	vector<uint64_t> rtt;
+	rtt.reserve(nof_round_trips);
+	for(int i = 0; i < nof_round_trips; i++)
+	{
+		uint64_t start = now_ns();
+		fifo_send(&m, to_client[1]);
+		fifo_blocking_read(&m, to_daemon[0]);
+		rtt.push_back(now_ns() - start);
+	}
+	waitpid(pid, NULL, 0);
+
+	fcntl(to_daemon[0], F_SETFL, fcntl(to_daemon[0], F_GETFL) | O_NONBLOCK);
+	uint64_t start = now_ns();
+	for(int i = 0; i < BENCH_NOF_POLLS; i++) {fifo_blocking_read(&m, to_daemon[0]);}
+	double poll_ns = (double)(now_ns() - start) / BENCH_NOF_POLLS;
+
+	print_result("FIFO", rtt, poll_ns);
+	close(to_client[0]); close(to_client[1]);
+	close(to_daemon[0]); close(to_daemon[1]);
+}
+
+/***************************************\
+* RTSIG									*
+\***************************************/
+static void run_rtsig()
+{
+	//block before fork => no signal gets lost or kills the child
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGRTMIN);
+	if(sigprocmask(SIG_BLOCK, &mask, NULL) == -1) {dexit("sigprocmask");}
+	pid_t daemon_pid = getpid();
+	struct signalfd_siginfo fdsi;
+	union sigval sv;
+	sv.sival_int = 0;
+
+	pid_t pid = fork();
+	if(pid == 0)
+	{
+		int sfd = signalfd(-1, &mask, 0);
+		if(sfd == -1) {dexit("signalfd");}
+		for(int i = 0; i < nof_round_trips; i++)
+		{
+			read(sfd, &fdsi, sizeof(struct signalfd_siginfo));
+			sigqueue(daemon_pid, SIGRTMIN, sv);
+		}
+		_exit(0); //no flush of the inherited stdout buffer
+	}
+
+	int sfd = signalfd(-1, &mask, 0);
+	if(sfd == -1) {dexit("signalfd");}
+	vector<uint64_t> rtt;
+	rtt.reserve(nof_round_trips);
+	for(int i = 0; i < nof_round_trips; i++)
+	{
+		uint64_t start = now_ns();
+		sigqueue(pid, SIGRTMIN, sv);
+		read(sfd, &fdsi, sizeof(struct signalfd_siginfo));
+		rtt.push_back(now_ns() - start);
+	}
+	waitpid(pid, NULL, 0);
+
+	fcntl(sfd, F_SETFL, fcntl(sfd, F_GETFL) | O_NONBLOCK);
+	uint64_t start = now_ns();
+	for(int i = 0; i < BENCH_NOF_POLLS; i++) {read(sfd, &fdsi, sizeof(struct signalfd_siginfo));}
+	double poll_ns = (double)(now_ns() - start) / BENCH_NOF_POLLS;
+
+	print_result("RTSIG", rtt, poll_ns);
+	close(sfd);
+	sigprocmask(SIG_UNBLOCK, &mask, NULL);
+}
+
+/***************************************\
+* SHM									*
+\***************************************/
+/*
+ * spin: never sleep, poll the ring until a message is there
+ */
+static void shm_read(struct uss_message *m, struct uss_shm_ring *ring, int spin)
+{
+	if(spin) {while(!shm_ring_pop(ring, m)) {}}
+	else {shm_blocking_read(m, ring, 0);}
+}
+
+static void run_shm(int spin)
+{
+	//same layout as with shm_open, but anonymous
+	void *ptr = mmap(NULL, sizeof(struct uss_shm_region), PROT_READ | PROT_WRITE,
+					MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(ptr == MAP_FAILED) {dexit("mmap");}
+	struct uss_shm_region *region = (struct uss_shm_region*)ptr;
+	struct uss_message m;
+	memset(&m, 0, sizeof(struct uss_message));
+
+	pid_t pid = fork();
+	if(pid == 0)
+	{
+		for(int i = 0; i < nof_round_trips; i++)
+		{
+			shm_read(&m, &region->to_client, spin);
+			shm_send(&m, &region->to_daemon, &region->to_daemon);
+		}
+		_exit(0); //no flush of the inherited stdout buffer
+	}
+
+	vector<uint64_t> rtt;
+	rtt.reserve(nof_round_trips);
+	for(int i = 0; i < nof_round_trips; i++)
+	{
+		uint64_t start = now_ns();
+		shm_send(&m, &region->to_client, &region->to_client);
+		shm_read(&m, &region->to_daemon, spin);
+		rtt.push_back(now_ns() - start);
+	}
+	waitpid(pid, NULL, 0);
+
+	uint64_t start = now_ns();
+	for(int i = 0; i < BENCH_NOF_POLLS; i++) {shm_blocking_read(&m, &region->to_daemon, 1);}
+	double poll_ns = (double)(now_ns() - start) / BENCH_NOF_POLLS;
+
+	print_result(spin ? "SHM spin" : "SHM futex", rtt, poll_ns);
+	munmap(ptr, sizeof(struct uss_shm_region));
+}
+
+int main(int argc, char** argv)
+{
+	nof_round_trips = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ROUND_TRIPS;
+	if(nof_round_trips < 1) {printf("syntax: uss_bench_transport [<round trips>]\n"); return -1;}
+
+	run_fifo();
+	run_rtsig();
+	run_shm(0);
+	//spinning only makes sense if both sides have a core of their own
+	if(sysconf(_SC_NPROCESSORS_ONLN) > 1) {run_shm(1);}
+	return 0;
+}
@@ -0,0 +1,76 @@
+#!/bin/bash
+#
+# user space scheduler (USS)
+# benchmarks
+# PLACEMENT
+# is a mixed batch of testappplacement jobs on CUDA, FPGA and STREAM
+# (the initial placement of the running daemon decides where they go,
+#  build it with USS_PLACEMENT set to each mode and compare)
+
+# syntax
+# uss_benchmark_placement.sh <nof jobs> [<seed>]
+# (run from uss/src with the daemon started and benchmark/average_ticks.txt
+#  made by 'make -C benchmark', prints makespan and average job turnaround
+#  time in ms)
+
+# (0)
+# variables and base parameters
+#
+CWD=`pwd`
+WD=$CWD
+TESTDIR=testapp
+BENCHDIR=benchmark
+TESTAPP=testappplacement
+NOFCLASSES=3
+JOBTURNAROUNDSFILENAME="uss_benchmark_placement.tmp"
+
+# (0)
+# parse input parameters
+#
+if [ "$1" == "--help" ] || [ $# -lt 1 ] || [ $# -gt 2 ] ; then
+	echo "uss_benchmark_placement.sh <nof jobs> [<seed>]"
+	exit 1
+fi
+NOFJOBS=${1}
+SEED=1
+if [ $# -eq 2 ] ; then
+	SEED=${2}
+fi
+
+# (1)
+# refresh some filenames
+#
+if [ -f $WD/$BENCHDIR/$JOBTURNAROUNDSFILENAME ] ; then
+	rm $WD/$BENCHDIR/$JOBTURNAROUNDSFILENAME
+fi
+touch $WD/$BENCHDIR/$JOBTURNAROUNDSFILENAME
+
+# (2)
+# remember complete batch time
+#
+START=`date +%s%N`
+
+# (3)
+# start all jobs in mixed order (same order for the same seed)
+#
+RANDOM=${SEED}
+for (( i=0 ; i<${NOFJOBS} ; i++ ))
+do
+	CLASS=`expr $RANDOM % $NOFCLASSES`
+	${WD}/${TESTDIR}/${TESTAPP} ${i} ${CLASS} >> ${WD}/$BENCHDIR/${JOBTURNAROUNDSFILENAME} &
+done
+
+# (4)
+# wait for the last one to finish
+#
+wait
+STOP=`date +%s%N`
+
+# (5)
+# print makespan and average job turnaround time
+#
+NOFDONE=`grep -c '^[0-9]' ${WD}/$BENCHDIR/${JOBTURNAROUNDSFILENAME}`
+AVGJOBTURNAROUNDTIME=`awk '/^[0-9]/ { sum += $2; n++ } END { if(n > 0) printf "%.2f", sum / n }' ${WD}/$BENCHDIR/${JOBTURNAROUNDSFILENAME}`
+DIFF=`expr \( ${STOP} - ${START} \) / 1000000`
+echo "makespan ${DIFF} avgturnaround ${AVGJOBTURNAROUNDTIME} jobs ${NOFDONE}/${NOFJOBS}"
+exit 0
@@ -1,309 +1,565 @@
-#ifndef CONFIG_INCLUDED
-#define CONFIG_INCLUDED
-
-//basic
-#include <stdlib.h>
-#include <stdio.h>
-#include <stdarg.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
-
-//socket
-#include <sys/socket.h>
-#include <sys/un.h>
-//memeset
-#include <string.h>
-
-//read and write
-#include <unistd.h>
-
-//integers
-#include <stdint.h>
-
-//pthread and signal
-#include <pthread.h>
-#include <signal.h>
-
-//string
-#include <string.h>
-
-//time
-#include <time.h>
-#include <sys/time.h>
-
-//pid
-#include <sys/types.h>
-
-//errno
-#include <errno.h>
-
-
-//maximum length of a string
-#define MAX_STRING_LEN 100
-//define half lenght to avoid calculations
-#define MAX_STRING_LEN_2 50
-
-
-/***************************************\
-* basic setup							*
-\***************************************/
-/*
- * communication method
- * WARNING: select only one!
- */
-#define USS_FIFO 1
-#define USS_RTSIG 0 
-
-#if(USS_RTSIG == 1)
-#include <sys/signalfd.h>
-#endif
-
-/*
- * DEBUG
- * can be chosen individually (the first is for files in common folder)
- */
-#define USS_DEBUG 0
-#define USS_DAEMON_DEBUG 0
-#define USS_LIBRARY_DEBUG 0
-
-/*
- * advanced debugging
- */
-#define USS_FILE_LOGGING 0
-
-
-/***************************************\
-* bechmarks								*
-\***************************************/
-#define BENCHMARK_DAEMON_CPUTIME 0
-#define BENCHMARK_REGISTRATION_TIME 0
-#define BENCHMARK_CONTEXTSWITCH_TIME 0
-#define BENCHMARK_LOAD_BALANCER 0
-
-/***************************************\
-* configuration/features				*
-\***************************************/
-/*
- * scheduling interval
- */
-#define USS_SCHED_INTERVAL_SEC 0
-#define USS_SCHED_INTERVAL_NSEC 50000000 //50ms
-
-/*
- * activate to use a file to read in accel specific base granularities 
- * (not yet implemneted)
- */
-#define USS_MIN_GRANULARITY_FROM_FILE 0
-
-/*
- * default base granularity
- * WARNING: this is only used if USS_MIN_GRANULARITY_FROM_FILE is 0
- * COMMENT: [micro seconds]
- */
-#define USS_MIN_GRANULARITY 1000000 //=1sec
-
-/*
- * bluemode
- * if cpu sysload is low enough, then send inactive handles to cpu instead of idle
- */
-#define USS_BLUEMODE 0
-
-/*
- * cpu sysload parameters
- * only if the current sysload is less or equal than the USS_CPU_THRESHOLD
- * more additional threads are allowed onto the CPU (no removing if too high)
- *
- * select to load from /proc filesystem OR per system call
- *
- * an update interval X means that the update is done very Xth iteration of daemon main loop
- */
-#define USS_CPU_THRESHOLD 10
-
-#define USS_SYSLOAD_FROM_PROC 0 //WARNING: not yet implemented
-#define USS_SYSLOAD_FROM_SYSCALL 1
-
-#define USS_SYSLOAD_UPDATE_INTERVAL 1
-
-#if(USS_SYSLOAD_FROM_SYSCALL == 1)
-#include <sys/sysinfo.h>
-#endif
-
-
-/*
- * should the user-space scheduler be ran as a daemon
- */
-#define USS_DAEMONIZE 0
-
-/*
- * number of maximal parallel worker threads
- */
-#define USS_MAX_LOCAL_THREADS 2048
-
-/*
- * for transporting the meta scheduling information
- * to uss_daemon (in particular to the scheduler itself)
- * a struct of constant size is used
- * -> the struct meta_sched_info is packed into
- *    a new struct meta_sched_info_transport
- */
-#define USS_MAX_MSI_TRANSPORT 10
-
-/*
- *push curve is used by push/pull loadbalancing mechanism
- */
-#define USS_MAX_PUSH_CURVE_LEN 20
-
-/*
- * limit thread concurrency for registrations
- */
-#define USS_NOF_MAX_DISPATCHER_THREADS 30
-
-
-/***************************************\
-* path names							*
-\***************************************/
-/*
- * unix socket addresses (path names)
- */
-#define USS_REGISTRATION_DAEMON_SOCKET "/tmp/uss_daemon_socket"
-#define USS_REGISTRATION_MULTIPLEXER_SOCKET "/tmp/uss_multi_socket"
-
-/*
- * the main directory of the USS
- */
-#define USS_DIRECTORY "/usr/bin/uss"
-
-/*
- * the complete file path for the device list
- */
-#define USS_FILE_DEVICELIST "/home/dwelp/uss/devicelist"
-
-/*
- * folder to create fifo's in
- */
-#define USS_FIFO_NAME_TEMPLATE "/tmp/uss/f.%ld"
-#define USS_FIFO_NAME_LEN (sizeof(USS_FIFO_NAME_TEMPLATE)+30)
-
-
-/***************************************\
-* other constants						*
-\***************************************/
-/*
- * error constants
- */
-#define USS_ERROR_GENERAL -10
-#define USS_ERROR_SCHED_DECLINED_REG -20
-#define USS_ERROR_TRANSPORT -30
-
-enum uss_control_entry_status
-{
-	USS_CONTROL_NOT_PROCESSED = 0,
-	USS_CONTROL_SCHED_ACCEPTED = 1,
-	USS_CONTROL_SCHED_DECLINED = -1,
-	USS_CONTROL_UNREGISTER_PENDING = 2,
-	USS_CONTROL_UNREGISTER_SUCCESSFUL = 3
-};
-
-enum uss_message_types
-{
-	USS_MESSAGE_NOT_SET = 0,
-	USS_MESSAGE_RUNON = 1,
-	USS_MESSAGE_CLEANUP_DONE = 3,
-	USS_MESSAGE_STATUS_REPORT = 4,
-	USS_MESSAGE_ISFINISHED = 5,
-	USS_MESSAGE_RESET = 6
-};
-
-/***************************************\
-* structs								*
-\***************************************/
-/*
- * this is used the address a registered client can be
- * communicated with
- */
-struct uss_address
-{
-	pid_t pid;
-#if(USS_FIFO == 1)	
-	long fifo; /*id of the fifo in addition to base name given in config*/
-	
-	bool operator==(const uss_address& other) const
-	{
-		return (pid == other.pid && fifo == other.fifo);
-	}
-	
-	bool operator< (const struct uss_address& a) const
-	{
-		return (this->pid < a.pid || (this->pid == a.pid && this->fifo < a.fifo));
-	}
-#elif(USS_RTSIG == 1)
-	int lid;
-	
-	bool operator==(const uss_address& other) const
-	{
-		return (pid == other.pid && lid == other.lid);
-	}
-	
-	bool operator< (const struct uss_address& a) const
-	{
-		return (this->pid < a.pid || (this->pid == a.pid && this->lid < a.lid));
-	}
-#endif
-};
-
-
-/*
- * during an registration attempt, three values are important
- * 1) a check value, that is sizeof(s meta_sched_addr_info) if
- *    everything went corretly or an error message otherwise
- * 2) client
- * 3) daemon
- */
-struct uss_registration_response
-{
-	int check;
-	struct uss_address client_addr;
-	struct uss_address daemon_addr;
-};
-
-
-/*
- * this is a container for transporting meta_sched_info
- * and the address from library to daemon
- * -> smaller array, because a user will not implement
- *    an algorithm for each accel
- */
-struct meta_sched_addr_info
-{
-	int length;
-	int accelerator_type[USS_MAX_MSI_TRANSPORT];
-	int affinity[USS_MAX_MSI_TRANSPORT];
-	int flags[USS_MAX_MSI_TRANSPORT];
-	struct uss_address addr;
-	pthread_t tid;
-};
-
-
-/*
- * a uss_message is the abstract form of a message that can be
- * passed in between the library call and daemon/scheduler
- */
-struct uss_message
-{
-	/* header */
-#if(USS_FIFO == 1)	
-	struct uss_address address;
-#elif(USS_RTSIG == 1)
-	//the address is implicitly transported by signal and in wrapped_int
-#endif	
-	int message_type;
-	
-	/* data */
-	int accelerator_type;
-	int accelerator_index;
-};
-
-
-#endif
-
+#ifndef CONFIG_INCLUDED
+#define CONFIG_INCLUDED
+
+//basic
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//socket
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <stddef.h>
+//memeset
+#include <string.h>
+
+//read and write
+#include <unistd.h>
+
+//integers
+#include <stdint.h>
+
+//pthread and signal
+#include <pthread.h>
+#include <signal.h>
+
+//string
+#include <string.h>
+
+//time
+#include <time.h>
+#include <sys/time.h>
+
+//pid
+#include <sys/types.h>
+
+//errno
+#include <errno.h>
+
+//event driven daemon main loop
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+//shared memory transport
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+
+//maximum length of a string
+#define MAX_STRING_LEN 100
+//define half lenght to avoid calculations
+#define MAX_STRING_LEN_2 50
+
+
+/***************************************\
+* basic setup							*
+\***************************************/
+/*
+ * communication method
+ * WARNING: select only one!
+ *
+ * FIFO:  an anonymous pipe per client thread, passed to the daemon
+ *        with SCM_RIGHTS (one syscall per message)
+ * RTSIG: realtime signals carrying a wrapped sigval (one syscall per message)
+ * SHM:   a shared memory region per client thread with lock-free rings
+ *        (syscalls only to wake up a sleeping peer)
+ */
+#define USS_FIFO 1
+#define USS_RTSIG 0 
+#define USS_SHM 0
+
+#if(USS_RTSIG == 1)
+#include <sys/signalfd.h>
+#endif
+
+/*
+ * shared run_on slot
+ * the daemon publishes run_on decisions (RUNON messages) into a memory
+ * mapped slot per client thread instead of sending them
+ * -> checkpoints in libuss_start only do an atomic load (no syscall)
+ * -> library sleeps on a futex of the slot while it is IDLE
+ */
+#define USS_SHARED_RUN_ON 1
+
+/*
+ * DEBUG
+ * can be chosen individually (the first is for files in common folder)
+ */
+#define USS_DEBUG 0
+#define USS_DAEMON_DEBUG 0
+#define USS_LIBRARY_DEBUG 0
+
+/*
+ * advanced debugging
+ */
+#define USS_FILE_LOGGING 0
+
+
+/***************************************\
+* bechmarks								*
+\***************************************/
+#define BENCHMARK_DAEMON_CPUTIME 0
+#define BENCHMARK_REGISTRATION_TIME 0
+#define BENCHMARK_CONTEXTSWITCH_TIME 0
+#define BENCHMARK_LOAD_BALANCER 0
+
+/***************************************\
+* configuration/features				*
+\***************************************/
+/*
+ * scheduling interval
+ * the daemon thread sleeps until the next event (registration, finished
+ * slice or job) or until the next min_granularity of a running handle is
+ * depleted
+ * -> this interval is only used as a retry if a rq is contended but its
+ *    current handle could not be preempted yet
+ */
+#define USS_SCHED_INTERVAL_SEC 0
+#define USS_SCHED_INTERVAL_NSEC 50000000 //50ms
+
+/*
+ * load balancing
+ * push/pull of handles between the mqs of different accelerator types
+ * -> runs every USS_LOAD_BALANCING_INTERVAL while handles are registered
+ * -> runs at once when pick_next found a rq empty (so it can pull)
+ */
+#define USS_LOAD_BALANCING 1
+#define USS_LOAD_BALANCING_INTERVAL_SEC 0
+#define USS_LOAD_BALANCING_INTERVAL_NSEC 250000000 //250ms
+
+/*
+ * max number of messages the dispatcher thread reads with one syscall
+ * (all messages of a read are handled as one batch)
+ */
+#define USS_DISPATCHER_BATCH 64
+
+/*
+ * activate to use a file to read in accel specific base granularities 
+ * (not yet implemneted)
+ */
+#define USS_MIN_GRANULARITY_FROM_FILE 0
+
+/*
+ * switch cost (init and free of a handle on an accelerator)
+ * -> measured by library and reported in cleanup messages (FIFO and SHM only)
+ * -> daemon keeps an EWMA per se and per accelerator type:
+ *    new = old + (sample - old) / 2^USS_SWITCH_COST_EWMA_SHIFT
+ * -> until anything is measured the default is used [nano seconds]
+ */
+#define USS_SWITCH_COST_EWMA_SHIFT 2
+#define USS_SWITCH_COST_DEFAULT 50000000 //50ms
+
+/*
+ * initial placement of a new job (add_job)
+ * -> USS_PLACEMENT_AFFINITY: first active accelerator type of the msai
+ *    (= highest affinity), balanced over the rqs of its mq
+ * -> USS_PLACEMENT_MIN_COMPLETION: the rq of any active type of the msai
+ *    where the job is expected to finish first (see uss_placement.h)
+ * -> compare them with benchmark/uss_benchmark_placement.sh
+ */
+#define USS_PLACEMENT_AFFINITY 0
+#define USS_PLACEMENT_MIN_COMPLETION 1
+#define USS_PLACEMENT USS_PLACEMENT_AFFINITY
+
+/*
+ * service time of a job (accelerator time until it is finished)
+ * -> daemon keeps an EWMA per accelerator type, normalized to
+ *    affinity 10 (a job of affinity 5 is expected to take twice as long)
+ *    and to a device of reference speed
+ * -> until anything is measured the default is used [nano seconds]
+ */
+#define USS_SERVICE_TIME_EWMA_SHIFT 2
+#define USS_SERVICE_TIME_DEFAULT 1000000000 //1sec
+
+/*
+ * speed of a device compared to the other devices of its type
+ * [percent of USS_PLACEMENT_SPEED_REFERENCE, see uss_placement.h]
+ * -> given in the devicelist ("4: 0@200 1@100" = device 0 is twice
+ *    as fast as device 1) or measured if missing there
+ * -> measured: the library reports the time of main() per slice, the
+ *    daemon keeps an EWMA of the time per call for each device and
+ *    compares it to the average of all measured devices of the type
+ *    (assumes every device of a type gets a similar mix of jobs)
+ * -> a device is counted as at least USS_DEVICE_SPEED_MIN and at most
+ *    USS_DEVICE_SPEED_MAX percent
+ */
+#define USS_DEVICE_SPEED_MEASURE 1
+#define USS_DEVICE_SPEED_EWMA_SHIFT 3
+#define USS_DEVICE_SPEED_MIN 25
+#define USS_DEVICE_SPEED_MAX 400
+
+/*
+ * deadline class
+ * -> each rq has a tree of jobs with a deadline that runs ahead of its
+ *    fair tree (earliest deadline first)
+ * -> a job is admitted to it if all deadlines of the rq can still be
+ *    met by the measured service times, otherwise it is scheduled fair
+ * -> with USS_DEADLINE_STATS each finished job with a deadline is
+ *    appended to the file named by the environment variable
+ *    USS_DEADLINE_STATS_ENV of the daemon, else USS_DEADLINE_STATS_FILE
+ *    (truncated on daemon start, a symlink is not followed):
+ *    <handle> <accel type> <edf|fair> <hit|miss> <lateness ms> <runtime ms>
+ *    (the totals of hits and misses are part of the status print anyway)
+ */
+#define USS_DEADLINE_STATS 0
+#define USS_DEADLINE_STATS_ENV "USS_DEADLINE_STATS_FILE"
+#define USS_DEADLINE_STATS_FILE "/tmp/uss_deadline_stats"
+
+/*
+ * admission control of new jobs (add_job)
+ * -> projected wait of a job = jobs already in the rq it is placed to
+ *    * measured service time of that type (see place_job)
+ *    (no bound before the first job of the type has been measured)
+ * -> if it exceeds USS_ADMISSION_MAX_WAIT_MS the registration is answered
+ *    with USS_CONTROL_SCHED_RETRY and the time [ms] until enough work of
+ *    the rq is done (within [USS_ADMISSION_RETRY_MIN_MS, USS_ADMISSION_RETRY_MAX_MS])
+ * -> the library waits (plus up to 1/USS_ADMISSION_RETRY_JITTER more so
+ *    declined jobs do not come back at once) and registers again
+ * -> jobs with a deadline are not bound by it (a retry would only make
+ *    them later), if not admitted to the deadline class they are scheduled fair
+ * -> USS_ADMISSION_MAX_WAIT_MS 0 disables admission control
+ */
+#define USS_ADMISSION_MAX_WAIT_MS 60000
+#define USS_ADMISSION_RETRY_MIN_MS 50
+#define USS_ADMISSION_RETRY_MAX_MS 10000
+#define USS_ADMISSION_RETRY_JITTER 4
+
+/*
+ * default base granularity
+ * WARNING: this is only used if USS_MIN_GRANULARITY_FROM_FILE is 0
+ * COMMENT: [micro seconds]
+ */
+#define USS_MIN_GRANULARITY 1000000 //=1sec
+
+/*
+ * bluemode
+ * if enough CPU cores are free, then send preempted handles to cpu instead of idle
+ * -> switched at runtime by update_sysload with a hysteresis: on when at least
+ *    USS_BLUEMODE_ON_FREE_CORES cores are free, off below USS_BLUEMODE_OFF_FREE_CORES
+ *    (cores used by the cpu-mode handles of USS count as free, each keeps one busy)
+ * -> at most USS_BLUEMODE_MAX_CPU_JOBS handles are in cpu-mode at once and never
+ *    more than there are free cores (minus USS_BLUEMODE_RESERVE_CORES)
+ *    => handles over this cap are sent back to idle
+ */
+#define USS_BLUEMODE 0
+
+#define USS_BLUEMODE_ON_FREE_CORES 2.0
+#define USS_BLUEMODE_OFF_FREE_CORES 1.0
+#define USS_BLUEMODE_RESERVE_CORES 1.0
+#define USS_BLUEMODE_MAX_CPU_JOBS 8
+
+/*
+ * cpu sysload parameters
+ * select to load from /proc filesystem OR per system call
+ * -> /proc/stat: busy time of each CPU since the last sample (free cores now)
+ * -> system call: loadavg over 1 minute (reacts slowly)
+ *
+ * the sysload is sampled every USS_SYSLOAD_UPDATE_INTERVAL [milli seconds]
+ * (with USS_BLUEMODE the daemon wakes up for it while handles are registered)
+ */
+#define USS_SYSLOAD_FROM_PROC 1
+#define USS_SYSLOAD_FROM_SYSCALL 0
+
+#define USS_SYSLOAD_UPDATE_INTERVAL 100
+
+#if(USS_SYSLOAD_FROM_SYSCALL == 1)
+#include <sys/sysinfo.h>
+#endif
+
+
+/*
+ * should the user-space scheduler be ran as a daemon
+ */
+#define USS_DAEMONIZE 0
+
+/*
+ * number of maximal parallel worker threads (per process)
+ * -> RTSIG: the narrow encoding carries 4096 of them, more need
+ *    the wide one (see uss_rtsig.h)
+ * -> the multi table grows in chunks up to this, so a large value
+ *    costs no memory until the lids are used
+ */
+#define USS_MAX_LOCAL_THREADS (1<<20)
+
+/*
+ * handles are used as index into the se slab of the scheduler
+ * -> the slab grows in chunks of USS_SLAB_CHUNK_LEN entries
+ * -> at most USS_MAX_HANDLES handles can be in use at the same time
+ */
+#define USS_SLAB_CHUNK_SHIFT 10
+#define USS_SLAB_CHUNK_LEN (1<<USS_SLAB_CHUNK_SHIFT)
+#define USS_SLAB_DIR_SHIFT 11
+#define USS_SLAB_DIR_LEN (1<<USS_SLAB_DIR_SHIFT)
+#define USS_MAX_HANDLES (USS_SLAB_DIR_LEN * USS_SLAB_CHUNK_LEN)
+
+/*
+ * a handle packs the slot index (low bits) and the generation of
+ * its slot (high bits) into one positive int
+ * -> the slot index is the index into the se slab
+ * -> the generation of a slot is bumped when its handle is freed, so
+ *    a stale handle never matches its slot again
+ */
+#define USS_HANDLE_INDEX_BITS (USS_SLAB_DIR_SHIFT + USS_SLAB_CHUNK_SHIFT)
+#define USS_HANDLE_INDEX_MASK ((1<<USS_HANDLE_INDEX_BITS) - 1)
+#define USS_HANDLE_GENERATION_MASK ((1<<(31 - USS_HANDLE_INDEX_BITS)) - 1)
+
+/*
+ * for transporting the meta scheduling information
+ * to uss_daemon (in particular to the scheduler itself)
+ * a struct of constant size is used
+ * -> the struct meta_sched_info is packed into
+ *    a new struct meta_sched_info_transport
+ */
+#define USS_MAX_MSI_TRANSPORT 10
+
+/*
+ *push curve is used by push/pull loadbalancing mechanism
+ */
+#define USS_MAX_PUSH_CURVE_LEN 20
+
+/*
+ * max number of registrations the scheduler accepts as one batch
+ * (and max number of events the registration server handles per epoll_wait)
+ */
+#define USS_REGISTRATION_BATCH 64
+
+/*
+ * max number of jobs one registration request (libuss_register_batch)
+ * may contain
+ */
+#define USS_MAX_REGISTRATION_REQUEST 1024
+
+/*
+ * max number of events the executor of submitted jobs (libuss_submit)
+ * handles per epoll_wait
+ */
+#define USS_EXECUTOR_BATCH 64
+
+/*
+ * USS_FIFO: the channel (write end of a pipe) of each job is passed
+ * to the daemon with SCM_RIGHTS while registering
+ * -> max number of channels passed with one sendmsg
+ *    (kernel limit SCM_MAX_FD is 253)
+ */
+#define USS_MAX_CHANNELS_PER_MESSAGE 64
+
+
+/***************************************\
+* path names							*
+\***************************************/
+/*
+ * unix socket addresses (path names)
+ * -> the multiplexer of a process binds <name>.<pid> in the abstract
+ *    namespace (nothing left in the file system when the process ends)
+ */
+#define USS_REGISTRATION_DAEMON_SOCKET "/tmp/uss_daemon_socket"
+#define USS_REGISTRATION_MULTIPLEXER_SOCKET "uss_multi_socket"
+
+/*
+ * the main directory of the USS
+ */
+#define USS_DIRECTORY "/usr/bin/uss"
+
+/*
+ * the complete file path for the device list
+ * -> one line per accelerator type: "<type>: <index>[@<speed>] ..."
+ *    (speed see USS_DEVICE_SPEED_*)
+ */
+#define USS_FILE_DEVICELIST "/home/dwelp/uss/devicelist"
+
+/*
+ * names of shared memory regions (shm_open)
+ * and number of messages in each ring (power of 2)
+ */
+#define USS_SHM_NAME_TEMPLATE "/uss.s.%ld"
+#define USS_SHM_NAME_LEN (sizeof(USS_SHM_NAME_TEMPLATE)+30)
+#define USS_SHM_RING_LEN 32
+
+/*
+ * names of the shared run_on slots (shm_open)
+ */
+#define USS_RUNON_NAME_TEMPLATE "/uss.r.%ld"
+#define USS_RUNON_NAME_LEN (sizeof(USS_RUNON_NAME_TEMPLATE)+30)
+
+
+/***************************************\
+* other constants						*
+\***************************************/
+/*
+ * error constants
+ */
+#define USS_ERROR_GENERAL -10
+#define USS_ERROR_SCHED_DECLINED_REG -20
+#define USS_ERROR_TRANSPORT -30
+
+enum uss_control_entry_status
+{
+	USS_CONTROL_NOT_PROCESSED = 0,
+	USS_CONTROL_SCHED_ACCEPTED = 1,
+	USS_CONTROL_SCHED_DECLINED = -1,
+	USS_CONTROL_UNREGISTER_PENDING = 2,
+	USS_CONTROL_UNREGISTER_SUCCESSFUL = 3,
+	USS_CONTROL_SCHED_RETRY = 4
+};
+
+enum uss_message_types
+{
+	USS_MESSAGE_NOT_SET = 0,
+	USS_MESSAGE_RUNON = 1,
+	USS_MESSAGE_CLEANUP_DONE = 3,
+	USS_MESSAGE_STATUS_REPORT = 4,
+	USS_MESSAGE_ISFINISHED = 5,
+	USS_MESSAGE_RESET = 6
+};
+
+/***************************************\
+* structs								*
+\***************************************/
+/*
+ * this is used the address a registered client can be
+ * communicated with
+ */
+struct uss_address
+{
+	pid_t pid;
+#if(USS_FIFO == 1)	
+	long fifo; /*id of the fifo in addition to base name given in config*/
+	
+	bool operator==(const uss_address& other) const
+	{
+		return (pid == other.pid && fifo == other.fifo);
+	}
+	
+	bool operator< (const struct uss_address& a) const
+	{
+		return (this->pid < a.pid || (this->pid == a.pid && this->fifo < a.fifo));
+	}
+#elif(USS_RTSIG == 1)
+	int lid;
+	int encoding; /*how messages to this address are wrapped (negotiated on registration, no part of the identity)*/
+	long runon; /*id of the run_on slot (given by the library, the lid is only known after registration)*/
+	
+	bool operator==(const uss_address& other) const
+	{
+		return (pid == other.pid && lid == other.lid);
+	}
+	
+	bool operator< (const struct uss_address& a) const
+	{
+		return (this->pid < a.pid || (this->pid == a.pid && this->lid < a.lid));
+	}
+#elif(USS_SHM == 1)
+	long shm; /*id of the shared memory region in addition to base name given in config*/
+	
+	bool operator==(const uss_address& other) const
+	{
+		return (pid == other.pid && shm == other.shm);
+	}
+	
+	bool operator< (const struct uss_address& a) const
+	{
+		return (this->pid < a.pid || (this->pid == a.pid && this->shm < a.shm));
+	}
+#endif
+};
+
+
+/*
+ * a registration request is this header followed by nof_msai
+ * meta_sched_addr_info (over the same connection)
+ * -> the daemon answers with a uss_registration_reply followed by
+ *    nof_msai uss_registration_response in the same order
+ * -> a connection may carry many requests without waiting for their
+ *    replies (pipelined), each is answered as soon as it is decided
+ *    on completely => replies may come in another order, request_id
+ *    (chosen by the sender) tells them apart
+ */
+struct uss_registration_request
+{
+	int request_id;
+	int nof_msai;
+};
+
+struct uss_registration_reply
+{
+	int request_id;
+	int nof_responses;
+};
+
+
+/*
+ * during an registration attempt, three values are important
+ * 1) a check value, that is sizeof(s meta_sched_addr_info) if
+ *    everything went corretly or an error message otherwise
+ *    (USS_CONTROL_SCHED_RETRY: daemon is too busy, see admission control)
+ * 2) client
+ * 3) daemon
+ */
+struct uss_registration_response
+{
+	int check;
+	int handle;
+	int retry_ms; //USS_CONTROL_SCHED_RETRY: register again after this time
+	struct uss_address client_addr;
+	struct uss_address daemon_addr;
+};
+
+
+/*
+ * this is a container for transporting meta_sched_info
+ * and the address from library to daemon
+ * -> smaller array, because a user will not implement
+ *    an algorithm for each accel
+ */
+struct meta_sched_addr_info
+{
+	int length;
+	int accelerator_type[USS_MAX_MSI_TRANSPORT];
+	int affinity[USS_MAX_MSI_TRANSPORT];
+	int flags[USS_MAX_MSI_TRANSPORT];
+	int nice;
+	uint64_t deadline; //CLOCK_MONOTONIC [ns], 0 = none
+	struct uss_address addr;
+	pthread_t tid;
+};
+
+
+/*
+ * a uss_message is the abstract form of a message that can be
+ * passed in between the library call and daemon/scheduler
+ */
+struct uss_message
+{
+	/* header */
+#if(USS_FIFO == 1 || USS_SHM == 1)	
+	struct uss_address address;
+	//handle of the job (given by the daemon on registration)
+	//-> messages of a job that is gone are dropped without a lookup
+	int handle;
+#elif(USS_RTSIG == 1)
+	//the address is implicitly transported by signal and in wrapped_int
+#endif	
+	int message_type;
+	
+	/* data */
+	int accelerator_type;
+	int accelerator_index;
+#if(USS_FIFO == 1 || USS_SHM == 1)
+	//measured by library for cleanup messages: time [ns] of init() and free()
+	//(there is no room for them in a wrapped rtsig int)
+	uint64_t init_ns;
+	uint64_t free_ns;
+	//and the time [ns] of all main() calls of the slice
+	uint64_t main_ns;
+	uint32_t nof_main;
+#endif
+};
+
+
+#endif
+
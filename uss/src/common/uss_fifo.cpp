@@ -1,119 +1,194 @@
-#include "./uss_config.h"
-#include "./uss_fifo.h"
-#include "./uss_tools.h"
-
-/***************************************\
-* installation 							*
-\***************************************/
-/*
- * to create and open a new file descriptor
- * and store created fifos index to addr->fifo
- *
- * returns fd or -1 on error
- */
-int fifo_install_receiver(struct uss_address *addr, int read, int write, int nonblocking)
-{
-	int ret, final_ret = -1;
-	char fifo_name[USS_FIFO_NAME_LEN];
-	long fifo_index;
-	if(addr->fifo == 0)
-	{
-		//create random new fifo
-		struct timeval tv;	
-		int fifo_creation_successful = 0;
-		for(int i = 0; i<10 && !fifo_creation_successful; i++)
-		{
-			ret = gettimeofday(&tv, NULL);
-			if(ret != 0) {dexit("fifo_install_receiver: gettimeofday");}
-			fifo_index = ((long)tv.tv_sec * 1000000 + (long)tv.tv_usec); /*index equals time in ms*/ 
-			
-			snprintf(fifo_name, USS_FIFO_NAME_LEN, USS_FIFO_NAME_TEMPLATE, fifo_index);
-			
-			ret = mkfifo(fifo_name, S_IRUSR | S_IWUSR | S_IWGRP);
-			if(ret == -1 && errno != EEXIST) {dexit("fifo_install_receiver: mkfifo");}
-			else if(ret == -1 && errno == EEXIST) {/*continue*/}
-			else {fifo_creation_successful = 1;}
-		}
-	}
-	else
-	{
-		//create specific new fifo depending value currently inside of addr->fifo
-		snprintf(fifo_name, USS_FIFO_NAME_LEN, USS_FIFO_NAME_TEMPLATE, addr->fifo);		
-		unlink(fifo_name);
-		
-		fifo_index = addr->fifo;
-		
-		ret = mkfifo(fifo_name, S_IRUSR | S_IWUSR | S_IWGRP);
-		if(ret == -1) {dexit("fifo_install_receiver: failed fo mkfifo with specific name");}		
-	}
-	
-	int flags = 0;
-	if(read == 1){flags |= O_RDONLY;}
-	if(write == 1){flags |= O_WRONLY;}
-	if(nonblocking == 1){flags |= O_NONBLOCK;}
-	
-#if(USS_DEBUG == 1)
-	printf("install_receiver on filename %s\n", fifo_name);
-#endif
-	final_ret = open(fifo_name, flags);
-	if(final_ret == -1) {dexit("fifo_install_receiver: open fifo");}
-	
-	addr->fifo = fifo_index;
-	return final_ret;
-}
-
-/*
- * open a file descriptor
- * for the fifo specified in addr
- *
- * returns fd or -1 on error
- */
-int fifo_install_sender(struct uss_address *addr, int read, int write, int nonblocking)
-{
-	int final_ret = -1;
-	char fifo_name[USS_FIFO_NAME_LEN];
-	snprintf(fifo_name, USS_FIFO_NAME_LEN, USS_FIFO_NAME_TEMPLATE, addr->fifo);
-	
-	int flags = 0;
-	if(read == 1){flags |= O_RDONLY;}
-	if(write == 1){flags |= O_WRONLY;}
-	if(nonblocking == 1){flags |= O_NONBLOCK;}
-#if(USS_DEBUG == 1)
-	printf("install_sender on filename %s\n", fifo_name);
-#endif
-	final_ret = open(fifo_name, flags);
-	if(final_ret == -1) {dexit("fifo_install_sender: prob when open fifo");}
-	return final_ret;
-}
-
-/***************************************\
-* send and receive						*
-\***************************************/
-/*
- * send a message via fifo
- *
- * return: 0 on success, -1 on target unreachable
- */
-int fifo_send(struct uss_message *message, int fd)
-{
-	ssize_t size_ret;
-	size_ret = write(fd, message, sizeof(struct uss_message));
-	if(errno == EPIPE)
-	{return -1;}
-	else if(size_ret != sizeof(struct uss_message))
-	{dexit("fifo_send: too small msg send");}
-	
-	return 0;
-}
-
-/*
- * blocking a message via fifo
- *
- * return ssize_t value equal to the bytes read
- */
-ssize_t fifo_blocking_read(struct uss_message *message, int fd)
-{
-	return read(fd, message, sizeof(struct uss_message));
-}
-
-
+#include "./uss_config.h"
+#include "./uss_fifo.h"
+#include "./uss_tools.h"
+
+#if(USS_FIFO == 1)
+/***************************************\
+* installation 							*
+\***************************************/
+/*
+ * to create a new anonymous channel (pipe) and store a unique
+ * index of it to addr->fifo (if not set yet)
+ * -> the write end is returned in sender_fd and has to be passed
+ *    to the peer with fifo_send_channels (no names, no path lookups)
+ *
+ * returns fd of the read end or -1 on error
+ */
+int fifo_install_receiver(struct uss_address *addr, int *sender_fd, int nonblocking)
+{
+	static long fifo_counter = 0;
+	int ret;
+	int fds[2];
+
+	ret = pipe2(fds, O_CLOEXEC);
+	if(ret == -1) {derr("fifo_install_receiver: pipe2"); return -1;}
+	if(nonblocking == 1)
+	{
+		ret = fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+		if(ret == -1) {dexit("fifo_install_receiver: fcntl");}
+	}
+
+	if(addr->fifo == 0)
+	{
+		//unique among all processes: pid (high) and counter (low)
+		long counter = __sync_add_and_fetch(&fifo_counter, 1);
+		addr->fifo = ((long)getpid() << 32) | (counter & 0xffffffff);
+	}
+#if(USS_DEBUG == 1)
+	printf("install_receiver on channel %ld\n", addr->fifo);
+#endif
+	*sender_fd = fds[1];
+	return fds[0];
+}
+
+/*
+ * a single sendmsg of up to len bytes that passes nof_fds file descriptors
+ * along with them (SCM_RIGHTS)
+ */
+static ssize_t fifo_sendmsg_channels(int sock, void *buf, size_t len, int *fds, int nof_fds, int flags)
+{
+	char control[CMSG_SPACE(USS_MAX_CHANNELS_PER_MESSAGE * sizeof(int))];
+	struct iovec iov;
+	struct msghdr msg;
+	if(nof_fds < 1 || nof_fds > USS_MAX_CHANNELS_PER_MESSAGE) {derr("fifo_send_channels: invalid number of fds"); errno = EINVAL; return -1;}
+
+	memset(control, 0, sizeof(control));
+	memset(&msg, 0, sizeof(struct msghdr));
+	iov.iov_base = buf;
+	iov.iov_len = len;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = CMSG_SPACE(nof_fds * sizeof(int));
+
+	struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(nof_fds * sizeof(int));
+	memcpy(CMSG_DATA(cmsg), fds, nof_fds * sizeof(int));
+
+	ssize_t size_ret;
+	do {size_ret = sendmsg(sock, &msg, flags);} while(size_ret == -1 && errno == EINTR);
+	return size_ret;
+}
+
+/*
+ * send len bytes over a unix socket and pass nof_fds file descriptors
+ * (at most USS_MAX_CHANNELS_PER_MESSAGE) along with them (SCM_RIGHTS)
+ *
+ * returns 0 or -1 on error
+ */
+int fifo_send_channels(int sock, void *buf, size_t len, int *fds, int nof_fds)
+{
+	ssize_t size_ret = fifo_sendmsg_channels(sock, buf, len, fds, nof_fds, MSG_NOSIGNAL);
+	if(size_ret == -1) {return -1;}
+
+	//fds went with the first bytes, the rest is plain data
+	size_t done = size_ret;
+	while(done < len)
+	{
+		size_ret = send(sock, ((char*)buf) + done, len - done, MSG_NOSIGNAL);
+		if(size_ret == -1 && errno == EINTR) {continue;}
+		if(size_ret <= 0) {return -1;}
+		done += size_ret;
+	}
+	return 0;
+}
+
+/*
+ * like fifo_send_channels, but sends only what fits without blocking
+ * (the fds go with the bytes sent, the rest is plain data)
+ *
+ * returns the number of bytes sent or -1 on error (EAGAIN: nothing fits)
+ */
+ssize_t fifo_try_send_channels(int sock, void *buf, size_t len, int *fds, int nof_fds)
+{
+	return fifo_sendmsg_channels(sock, buf, len, fds, nof_fds, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+/*
+ * read up to len bytes from a unix socket and append file descriptors
+ * passed along (SCM_RIGHTS) to fds[*nof_fds] (at most max_fds in total)
+ *
+ * return ssize_t value equal to the bytes read (like read)
+ */
+ssize_t fifo_recv_channels(int sock, void *buf, size_t len, int *fds, int max_fds, int *nof_fds)
+{
+	char control[CMSG_SPACE(USS_MAX_CHANNELS_PER_MESSAGE * sizeof(int))];
+	struct iovec iov;
+	struct msghdr msg;
+
+	memset(&msg, 0, sizeof(struct msghdr));
+	iov.iov_base = buf;
+	iov.iov_len = len;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	ssize_t size_ret = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+	if(size_ret == -1) {return -1;}
+	if(msg.msg_flags & MSG_CTRUNC) {derr("fifo_recv_channels: too many fds in one message"); errno = EBADMSG; return -1;}
+
+	for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if(cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {continue;}
+		int n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+		int *received = (int*)CMSG_DATA(cmsg);
+		for(int i = 0; i < n; i++)
+		{
+			//more than announced, nobody will ever use it
+			if(*nof_fds >= max_fds) {close(received[i]); errno = EBADMSG; size_ret = -1; continue;}
+			fds[(*nof_fds)++] = received[i];
+		}
+	}
+	return size_ret;
+}
+#endif
+
+/***************************************\
+* send and receive						*
+\***************************************/
+/*
+ * send a message via fifo
+ *
+ * return: 0 on success, -1 on target unreachable
+ */
+int fifo_send(struct uss_message *message, int fd)
+{
+	ssize_t size_ret;
+	size_ret = write(fd, message, sizeof(struct uss_message));
+	if(size_ret == -1 && errno == EPIPE)
+	{return -1;}
+	else if(size_ret != sizeof(struct uss_message))
+	{dexit("fifo_send: too small msg send");}
+	
+	return 0;
+}
+
+/*
+ * blocking a message via fifo
+ *
+ * return ssize_t value equal to the bytes read
+ */
+ssize_t fifo_blocking_read(struct uss_message *message, int fd)
+{
+	return read(fd, message, sizeof(struct uss_message));
+}
+
+/*
+ * blocking read of up to max messages via fifo
+ * (returns as soon as at least one message is available)
+ *
+ * COMMENT:
+ * a message is smaller than PIPE_BUF => every write is atomic
+ * and only whole messages are read
+ *
+ * return ssize_t value equal to the bytes read
+ */
+ssize_t fifo_batch_read(struct uss_message *messages, int max, int fd)
+{
+	return read(fd, messages, max * sizeof(struct uss_message));
+}
+
+
@@ -1,12 +1,17 @@
-#ifndef FIFO_H_INCLUDED
-#define FIFO_H_INCLUDED
-
-#include "./uss_config.h"
-
-int fifo_install_receiver(struct uss_address *addr, int read, int write, int nonblocking);
-int fifo_install_sender(struct uss_address *addr, int read, int write, int nonblocking);
-
-int fifo_send(struct uss_message *message, int fd);
-ssize_t fifo_blocking_read(struct uss_message *message, int fd);
-
+#ifndef FIFO_H_INCLUDED
+#define FIFO_H_INCLUDED
+
+#include "./uss_config.h"
+
+#if(USS_FIFO == 1)
+int fifo_install_receiver(struct uss_address *addr, int *sender_fd, int nonblocking);
+int fifo_send_channels(int sock, void *buf, size_t len, int *fds, int nof_fds);
+ssize_t fifo_try_send_channels(int sock, void *buf, size_t len, int *fds, int nof_fds);
+ssize_t fifo_recv_channels(int sock, void *buf, size_t len, int *fds, int max_fds, int *nof_fds);
+#endif
+
+int fifo_send(struct uss_message *message, int fd);
+ssize_t fifo_blocking_read(struct uss_message *message, int fd);
+ssize_t fifo_batch_read(struct uss_message *messages, int max, int fd);
+
 #endif
\ No newline at end of file
@@ -1,392 +1,668 @@
-#include "./uss_config.h"
-#include "./uss_rtsig.h"
-#include "./uss_tools.h"
-
-/***************************************\
-* installation (make any T a listener)	*
-\***************************************/
-/*
- * to create and obtain a new NONBLOCKING socket file descriptor
- *
- * (!) this will block SIGRTMIN for this thread only
- *
- * returns -1 on error
- */
-int rtsig_install_receiver(int listen_on_rtsig, int nonblock_on)
-{
-	//make thread "immune" to realtime signals
-	sigset_t immune_set;
-	sigemptyset(&immune_set);
-	sigaddset(&immune_set, (SIGRTMIN+listen_on_rtsig));
-	pthread_sigmask(SIG_BLOCK, &immune_set, NULL);
-
-#if(USS_LIBRARY_DEBUG == 1)
-	//printf("SIGRTMIN=%i\n", (int)SIGRTMIN);
-	//printf("immune to %i\n", (int)SIGRTMIN+listen_on_rtsig);
-#endif
-
-	//prepare parameters
-	int fd;	
-	sigset_t mask;
-	sigemptyset(&mask);
-	sigaddset(&mask, SIGRTMIN+listen_on_rtsig);
-
-	if(nonblock_on != 0)
-	{
-		//create new NONBLOCKING fd for realtime signal SIGRTMIN
-		fd = signalfd(-1, &mask, SFD_NONBLOCK);
-		if(fd == -1) {derr("problem with signal file descriptor"); return USS_ERROR_GENERAL;}	
-	}
-	else
-	{
-		//create new NONBLOCKING fd for realtime signal SIGRTMIN
-		fd = signalfd(-1, &mask, 0);
-		if(fd == -1) {derr("problem with signal file descriptor"); return USS_ERROR_GENERAL;}	
-	}
-	return fd;
-}
-
-
-/***************************************\
-* message wrapper function				*
-\***************************************/
-void convert_uss_to_int(struct uss_address *a, struct uss_message *m, int *i)
-{
-	int wrapped_int = 0;
-	if(m->message_type >= (int)(1<<USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_LEN)) dexit("send_rtsig: message_type oob");
-	if(m->accelerator_type >= (int)(1<<USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_LEN)) dexit("send_rtsig: message_type oob");
-	if(m->accelerator_index >= (int)(1<<USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_LEN)) dexit("send_rtsig: message_type oob");
-	if(a->lid >= (int)(1<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN)) dexit("send_rtsig: message_type oob");
-	
-	wrapped_int |= (m->message_type<<USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS);
-	wrapped_int |= (m->accelerator_type<<USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS);
-	wrapped_int |= (m->accelerator_index<<USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS);
-	wrapped_int |= (a->lid<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS);
-	
-	*i = wrapped_int;
-}
-
-void convert_int_to_uss(int wrapped_int, struct uss_address *a, struct uss_message *m)
-{
-	int message_type_selector = ((1<<USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_LEN) - 1) << USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS;
-	int accelerator_type_selector = ((1<<USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_LEN) - 1) << USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS;
-	int accelerator_index_selector = ((1<<USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_LEN) - 1) << USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS;
-	int lid_selector = ((1<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN) - 1) << USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS;
-	
-	int message_type = (wrapped_int & message_type_selector) >> USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS;
-	int accelerator_type = (wrapped_int & accelerator_type_selector) >> USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS;
-	int accelerator_index = (wrapped_int & accelerator_index_selector) >> USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS;
-	int lid = (wrapped_int & lid_selector) >> USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS;
-	
-	//fill parameters that are return via ptr
-	a->lid = lid;
-		
-	m->message_type = message_type;
-	m->accelerator_type = accelerator_type;
-	m->accelerator_index = accelerator_index;
-}
-
-
-/***************************************\
-* message send/receive RTSIG private	*
-\***************************************/
-/*
- * send a message via realtime signals 
- *
- * return: 0 on success, -1 on target unreachable
- */
-int rtsig_send(int signo, pid_t receiver_pid, int data)
-{
-#if(USS_DEBUG == 1)
-	printf("sending signal to pid %i with message %i\n", 
-			(int)receiver_pid, data);
-#endif
-	union sigval sv;
-	sv.sival_int = data;
-	int ret = sigqueue(receiver_pid, SIGRTMIN+(signo), sv); 
-	return ret; 
-}
-
-/*
- * blocking receive
- *
- * can be awakend by a FLUSH
- */
-ssize_t rtsig_blocking_read(int sfd, struct signalfd_siginfo *fdsi)
-{
-	return read(sfd, fdsi, sizeof(struct signalfd_siginfo));
-}
-
-
-
-//////////////////////////////////////////////
-//											//
-// static multiplexer						//
-//											//
-//////////////////////////////////////////////
-/***************************************\
-* multi talbe							*
-\***************************************/
-struct multi_table_entry
-{
-	pthread_t local_thread;
-};
-struct multi_table_entry multi_table[USS_MAX_LOCAL_THREADS];
-
-/*
- * the multiplexer is required is one process wants to
- * register more threads than one
- * -> with the current mechanism of realtime signals a
- *    rtsig send from daemon can be received from any thread
- *    and would be 'consumed/wasted' there
- *
- * => the multiplexer is a stub receiving rtsigs in order to
- *    hide a TID in the integer value
- */
-int multiplexer_started = 0;
-pthread_t registration_multiplexer_thread;
-pthread_mutex_t multiplexer_mtx = PTHREAD_MUTEX_INITIALIZER;
-
-
-/***************************************\
-* bit map								*
-\***************************************/
-short local_thread_bitmap[USS_MAX_LOCAL_THREADS];
-
-/*
- *returns a free lid or negative if no more avail
- *depends on USS_MAX_LOCAL_THREADS
- */
-int libuss_get_new_multi_table_index()
-{
-	int ret, i;
-	int final_ret = -1;
-	ret = pthread_mutex_lock(&multiplexer_mtx);
-	if(ret != 0) dexit("thread_mutex_lock");
-
-	for(i = 0; i < USS_MAX_LOCAL_THREADS; i++)
-	{
-		if(local_thread_bitmap[i] == 0)
-		{
-			local_thread_bitmap[i] = 1;
-			final_ret = i;
-			break;
-		}
-	}	
-	
-	ret = pthread_mutex_unlock(&multiplexer_mtx);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	return final_ret;
-}
-
-/*
- *clears bit in bitmap
- */
-void libuss_clear_multi_table_index(int x)
-{
-	int ret;
-	ret = pthread_mutex_lock(&multiplexer_mtx);
-	if(ret != 0) dexit("thread_mutex_lock");
-
-	local_thread_bitmap[x] = 0;
-	
-	ret = pthread_mutex_unlock(&multiplexer_mtx);
-	if(ret != 0) dexit("thread_mutex_unlock");
-}
-
-/***************************************\
-* multiplexer registration thread		*
-\***************************************/
-/*
- *this thread hijacks outgoing registration attempts
- *and slices in a local ID
- *it is also a thread that can receive SIGRTMIN+0
- */
-void* libuss_registration_multiplexer_thread(void *args)
-{
-	pthread_detach(pthread_self());
-	int ret;
-	int *fd_multiplexer_ptr = (int*)args;
-	int fd_multiplexer = *fd_multiplexer_ptr;
-	int fd_localthread, fd_daemon;
-
-	//SIGRTMIN+0 has to be unlocked
-	sigset_t unimmune_set;
-	sigemptyset(&unimmune_set);
-	sigaddset(&unimmune_set, (SIGRTMIN+0));
-	pthread_sigmask(SIG_UNBLOCK, &unimmune_set, NULL);
-	//
-	//loop for each new accepted connection (create no new thread for each => many regs may be delayed)
-	//
-	while(1)
-	{
-		//
-		//wait for reg attempt from a local thread that uses multiplexer
-		//
-		fd_localthread = accept(fd_multiplexer, NULL, NULL);
-		if(fd_localthread==-1) {printf("dderror: accept failed\n"); exit(1);}
-		
-		//
-		//now new connection to daemon
-		//
-		struct sockaddr_un client_addr;
-		
-		fd_daemon = socket(AF_UNIX, SOCK_STREAM, 0);
-		if(fd_daemon == -1) {dexit("error creating socket -> quit");}
-		
-		memset(&client_addr, 0, sizeof(struct sockaddr_un));
-		client_addr.sun_family = AF_UNIX;
-		strncpy(client_addr.sun_path, USS_REGISTRATION_DAEMON_SOCKET, sizeof(client_addr.sun_path)-1);
-		
-		ret = connect(fd_daemon, (struct sockaddr*) &client_addr, sizeof(struct sockaddr_un));
-		if(ret == -1) 
-		{
-			printf("error connecting socket\n");
-			close(fd_localthread);
-			dexit("multiplexer could not connect to daemon -> quit");
-		}
-		else
-		{
-		//
-		//read meta_sched_addr_info from local thread
-		//
-		struct meta_sched_addr_info transport;
-		memset(&transport, 0, sizeof(struct meta_sched_addr_info));
-		int nof_br = read(fd_localthread, &transport, sizeof(struct meta_sched_addr_info));
-		
-		//if we received too small msai return error value
-		if(nof_br != sizeof(struct meta_sched_addr_info))
-		{
-			dexit("received too small msai");
-		}
-		
-		//
-		//create multi_table entry
-		//
-		int index = libuss_get_new_multi_table_index();
-		if(index < 0) 
-		{
-			close(fd_localthread);
-			close(fd_daemon);
-			dexit("too many threads per process");
-		}
-		else
-		{		
-			multi_table[index].local_thread = transport.tid;
-			
-			//
-			//write modified meta_sched_addr_info to daemon
-			//
-			transport.addr.lid = index;
-			write(fd_daemon, &transport, sizeof(struct meta_sched_addr_info));
-			
-			//
-			//read uss_response from daemon
-			//
-			struct uss_registration_response resp;
-			read(fd_daemon, &resp, sizeof(uss_registration_response));
-			
-			//
-			//write modfied uss_response back to local thread
-			//
-			resp.client_addr.pid = getpid();
-			resp.client_addr.lid = index;
-			write(fd_localthread, &resp, sizeof(struct uss_registration_response));
-
-#if(USS_DEBUG == 1)			
-			printf("SCHED RESP CHECK: %i\n", resp.check);
-#endif
-
-			//
-			//depending on sched response, keep or clear saved state for this local thread
-			//
-			if(resp.check == USS_CONTROL_SCHED_ACCEPTED)
-			{
-			}
-			else if(resp.check == USS_CONTROL_SCHED_DECLINED)
-			{
-				libuss_clear_multi_table_index(index);
-			}
-			else
-			{
-				//sth odd happend
-				dexit("wrong scheduler response");
-			}
-			}
-			//close own connection with daemon
-			close(fd_daemon);
-		}
-	}//end while	
-	
-	return NULL;
-}
-
-
-/***************************************\
-* multiplexer message thread			*
-\***************************************/
-void incoming_sig_handler(int sig, siginfo_t *si, void *ucontext)
-{
-	struct uss_address addr;
-	struct uss_message mess;
-	union sigval sv = si->si_value;
-	int wrapped_int = si->si_value.sival_int;
-
-	convert_int_to_uss(wrapped_int, &addr, &mess);	
-
-	pthread_sigqueue(multi_table[addr.lid].local_thread, SIGRTMIN+1, sv);
-}
-
-
-/***************************************\
-* multiplexer start						*
-\***************************************/
-int libuss_start_multiplexer()
-{
-	//
-	//try to create a multiplexer socket
-	//
-	int ret;
-	ret = pthread_mutex_lock(&multiplexer_mtx);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	if(multiplexer_started == 0)
-	{
-		int ret, fd_multiplexer;
-		struct sockaddr_un server_addr;
-		
-		//create a socket
-		ret = remove(USS_REGISTRATION_MULTIPLEXER_SOCKET);
-		if(ret == -1 && errno != ENOENT) {dexit("problem when trying to remove old socket");}
-		
-		fd_multiplexer = socket(AF_UNIX, SOCK_STREAM, 0);
-		if(fd_multiplexer==-1) {dexit("dderror: creating socket\n");}
-		
-		memset(&server_addr, 0, sizeof(struct sockaddr_un));
-		server_addr.sun_family = AF_UNIX;
-		strncpy(server_addr.sun_path, USS_REGISTRATION_MULTIPLEXER_SOCKET, sizeof(server_addr.sun_path)-1);
-		
-		ret = bind(fd_multiplexer, (struct sockaddr*) &server_addr, sizeof(struct sockaddr_un));
-		if(fd_multiplexer==-1) {dexit("dderror: binding socket failed\n");}
-		
-		ret = listen(fd_multiplexer, 128);
-		if(fd_multiplexer==-1) {dexit("dderror: listen on socket failed\n");}
-			
-		pthread_create(&registration_multiplexer_thread, NULL, libuss_registration_multiplexer_thread, &fd_multiplexer);
-		
-		struct sigaction sa;
-		sa.sa_flags = SA_SIGINFO | SA_RESTART;
-		sa.sa_sigaction = incoming_sig_handler;
-		sigemptyset(&sa.sa_mask);
-		ret = sigaction((SIGRTMIN+0), &sa, NULL);
-		if(ret == -1) {printf("dderror: signal int not established\n"); exit(1);}
-		
-		multiplexer_started = 1;
-	}
-	
-	ret = pthread_mutex_unlock(&multiplexer_mtx);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	return 0;
+#include "./uss_config.h"
+#include "./uss_rtsig.h"
+#include "./uss_tools.h"
+
+#include <map>
+#include <vector>
+
+using namespace std;
+
+/***************************************\
+* installation (make any T a listener)	*
+\***************************************/
+/*
+ * to create and obtain a new NONBLOCKING socket file descriptor
+ *
+ * (!) this will block SIGRTMIN for this thread only
+ *
+ * returns -1 on error
+ */
+int rtsig_install_receiver(int listen_on_rtsig, int nonblock_on)
+{
+	//make thread "immune" to realtime signals
+	sigset_t immune_set;
+	sigemptyset(&immune_set);
+	sigaddset(&immune_set, (SIGRTMIN+listen_on_rtsig));
+	pthread_sigmask(SIG_BLOCK, &immune_set, NULL);
+
+#if(USS_LIBRARY_DEBUG == 1)
+	//printf("SIGRTMIN=%i\n", (int)SIGRTMIN);
+	//printf("immune to %i\n", (int)SIGRTMIN+listen_on_rtsig);
+#endif
+
+	//prepare parameters
+	int fd;	
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGRTMIN+listen_on_rtsig);
+
+	if(nonblock_on != 0)
+	{
+		//create new NONBLOCKING fd for realtime signal SIGRTMIN
+		fd = signalfd(-1, &mask, SFD_NONBLOCK);
+		if(fd == -1) {derr("problem with signal file descriptor"); return USS_ERROR_GENERAL;}	
+	}
+	else
+	{
+		//create new NONBLOCKING fd for realtime signal SIGRTMIN
+		fd = signalfd(-1, &mask, 0);
+		if(fd == -1) {derr("problem with signal file descriptor"); return USS_ERROR_GENERAL;}	
+	}
+	return fd;
+}
+
+
+/***************************************\
+* message wrapper function				*
+\***************************************/
+/*
+ * called by the daemon on registration: a->encoding is the best
+ * encoding the library can receive, it is replaced by the one both
+ * sides use from now on
+ *
+ * returns -1 if the lid of a fits no common encoding
+ */
+int rtsig_negotiate_encoding(struct uss_address *a)
+{
+	int encoding = USS_RTSIG_ENCODING_NARROW;
+	if(a->encoding == USS_RTSIG_ENCODING_WIDE && USS_RTSIG_ENCODING_BEST == USS_RTSIG_ENCODING_WIDE)
+	{
+		encoding = USS_RTSIG_ENCODING_WIDE;
+	}
+	if(a->lid < 0 || a->lid >= USS_RTSIG_MAX_LID(encoding)) {return -1;}
+	a->encoding = encoding;
+	return 0;
+}
+
+/*
+ * the value always travels in sival_ptr
+ * (a narrow one is zero extended => its marker bit is never set)
+ */
+void convert_uss_to_sigval(struct uss_address *a, struct uss_message *m, union sigval *sv)
+{
+	uint64_t value = 0;
+	if(a->encoding == USS_RTSIG_ENCODING_WIDE)
+	{
+		if(m->message_type >= (int)(1<<USS_WRAPPED_WIDE_RTSIG_MESSAGE_TYPE_LEN)) dexit("send_rtsig: message_type oob");
+		if(m->accelerator_type >= (int)(1<<USS_WRAPPED_WIDE_RTSIG_ACCEL_TYPE_LEN)) dexit("send_rtsig: accelerator_type oob");
+		if(m->accelerator_index >= (int)(1<<USS_WRAPPED_WIDE_RTSIG_ACCEL_INDEX_LEN)) dexit("send_rtsig: accelerator_index oob");
+		if(a->lid >= (int)(1<<USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_LEN)) dexit("send_rtsig: lid oob");
+		
+		value |= ((uint64_t)m->message_type<<USS_WRAPPED_WIDE_RTSIG_MESSAGE_TYPE_POS);
+		value |= ((uint64_t)m->accelerator_type<<USS_WRAPPED_WIDE_RTSIG_ACCEL_TYPE_POS);
+		value |= ((uint64_t)m->accelerator_index<<USS_WRAPPED_WIDE_RTSIG_ACCEL_INDEX_POS);
+		value |= ((uint64_t)a->lid<<USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_POS);
+		value |= ((uint64_t)1<<USS_WRAPPED_WIDE_RTSIG_MARKER_POS);
+	}
+	else
+	{
+		int wrapped_int = 0;
+		if(m->message_type >= (int)(1<<USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_LEN)) dexit("send_rtsig: message_type oob");
+		if(m->accelerator_type >= (int)(1<<USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_LEN)) dexit("send_rtsig: accelerator_type oob");
+		if(m->accelerator_index >= (int)(1<<USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_LEN)) dexit("send_rtsig: accelerator_index oob");
+		if(a->lid >= (int)(1<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN)) dexit("send_rtsig: lid oob");
+		
+		wrapped_int |= (m->message_type<<USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS);
+		wrapped_int |= (m->accelerator_type<<USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS);
+		wrapped_int |= (m->accelerator_index<<USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS);
+		wrapped_int |= (a->lid<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS);
+		value = (uint32_t)wrapped_int;
+	}
+	
+	memset(sv, 0, sizeof(union sigval));
+	sv->sival_ptr = (void*)(uintptr_t)value;
+}
+
+/*
+ * value is the sival_ptr of a received signal (signalfd: ssi_ptr)
+ */
+void convert_sigval_to_uss(uint64_t value, struct uss_address *a, struct uss_message *m)
+{
+	if(value & ((uint64_t)1<<USS_WRAPPED_WIDE_RTSIG_MARKER_POS))
+	{
+		a->lid = (int)((value >> USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_POS) & ((1<<USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_LEN) - 1));
+		a->encoding = USS_RTSIG_ENCODING_WIDE;
+		
+		m->message_type = (int)((value >> USS_WRAPPED_WIDE_RTSIG_MESSAGE_TYPE_POS) & ((1<<USS_WRAPPED_WIDE_RTSIG_MESSAGE_TYPE_LEN) - 1));
+		m->accelerator_type = (int)((value >> USS_WRAPPED_WIDE_RTSIG_ACCEL_TYPE_POS) & ((1<<USS_WRAPPED_WIDE_RTSIG_ACCEL_TYPE_LEN) - 1));
+		m->accelerator_index = (int)((value >> USS_WRAPPED_WIDE_RTSIG_ACCEL_INDEX_POS) & ((1<<USS_WRAPPED_WIDE_RTSIG_ACCEL_INDEX_LEN) - 1));
+		return;
+	}
+	
+	int wrapped_int = (int)(uint32_t)value;
+	int message_type_selector = ((1<<USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_LEN) - 1) << USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS;
+	int accelerator_type_selector = ((1<<USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_LEN) - 1) << USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS;
+	int accelerator_index_selector = ((1<<USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_LEN) - 1) << USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS;
+	int lid_selector = ((1<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN) - 1) << USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS;
+	
+	int message_type = (wrapped_int & message_type_selector) >> USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS;
+	int accelerator_type = (wrapped_int & accelerator_type_selector) >> USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS;
+	int accelerator_index = (wrapped_int & accelerator_index_selector) >> USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS;
+	int lid = (wrapped_int & lid_selector) >> USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS;
+	
+	//fill parameters that are return via ptr
+	a->lid = lid;
+	a->encoding = USS_RTSIG_ENCODING_NARROW;
+		
+	m->message_type = message_type;
+	m->accelerator_type = accelerator_type;
+	m->accelerator_index = accelerator_index;
+}
+
+
+/***************************************\
+* message send/receive RTSIG private	*
+\***************************************/
+/*
+ * send a message via realtime signals 
+ *
+ * return: 0 on success, -1 on target unreachable
+ */
+int rtsig_send(int signo, pid_t receiver_pid, union sigval sv)
+{
+#if(USS_DEBUG == 1)
+	printf("sending signal to pid %i with message %llx\n", 
+			(int)receiver_pid, (unsigned long long)(uintptr_t)sv.sival_ptr);
+#endif
+	int ret = sigqueue(receiver_pid, SIGRTMIN+(signo), sv); 
+	return ret; 
+}
+
+/*
+ * blocking receive
+ *
+ * can be awakend by a FLUSH
+ */
+ssize_t rtsig_blocking_read(int sfd, struct signalfd_siginfo *fdsi)
+{
+	return read(sfd, fdsi, sizeof(struct signalfd_siginfo));
+}
+
+/*
+ * blocking receive of up to max signals
+ * (returns as soon as at least one signal is pending)
+ */
+ssize_t rtsig_batch_read(int sfd, struct signalfd_siginfo *fdsi, int max)
+{
+	return read(sfd, fdsi, max * sizeof(struct signalfd_siginfo));
+}
+
+
+
+//////////////////////////////////////////////
+//											//
+// static multiplexer						//
+//											//
+//////////////////////////////////////////////
+/***************************************\
+* multi talbe							*
+\***************************************/
+/*
+ * the multiplexer is required is one process wants to
+ * register more threads than one
+ * -> with the current mechanism of realtime signals a
+ *    rtsig send from daemon can be received from any thread
+ *    and would be 'consumed/wasted' there
+ *
+ * => the multiplexer is a stub receiving rtsigs in order to
+ *    hide a TID in the integer value
+ */
+int multiplexer_started = 0;
+pthread_t registration_multiplexer_thread;
+pthread_mutex_t multiplexer_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * the multi table maps a lid to its local thread
+ * -> it is kept in chunks of USS_MULTI_CHUNK_LEN lids, a chunk is
+ *    allocated when its first lid is handed out (and kept until exit)
+ *    => grows up to USS_MAX_LOCAL_THREADS without a rebuild
+ * -> a chunk holds the word packed bitmap of its lids
+ *
+ * COMMENT:
+ * lids are taken by the multiplexer thread and given back by the
+ * finishing local threads => no lock, a bit is flipped with a CAS
+ * and the signal handler reads the thread with an atomic load
+ */
+#define USS_MULTI_CHUNK_WORDS 64
+#define USS_MULTI_CHUNK_LEN (USS_MULTI_CHUNK_WORDS*64)
+#define USS_MULTI_DIR_LEN ((USS_MAX_LOCAL_THREADS + USS_MULTI_CHUNK_LEN - 1) / USS_MULTI_CHUNK_LEN)
+
+struct multi_table_chunk
+{
+	uint64_t used[USS_MULTI_CHUNK_WORDS];
+	pthread_t local_thread[USS_MULTI_CHUNK_LEN];
+};
+static struct multi_table_chunk *multi_table[USS_MULTI_DIR_LEN];
+
+//word (over all chunks) to start searching for a free lid
+static unsigned int multi_table_hint;
+
+
+/***************************************\
+* bit map								*
+\***************************************/
+/*
+ * returns chunk c, allocates it if it is not there yet
+ */
+static struct multi_table_chunk* libuss_multi_table_chunk(unsigned int c)
+{
+	struct multi_table_chunk *chunk = __atomic_load_n(&multi_table[c], __ATOMIC_ACQUIRE);
+	if(chunk != NULL) {return chunk;}
+
+	struct multi_table_chunk *new_chunk = (struct multi_table_chunk*)calloc(1, sizeof(struct multi_table_chunk));
+	if(new_chunk == NULL) {dexit("libuss_multi_table_chunk: calloc");}
+	if(!__atomic_compare_exchange_n(&multi_table[c], &chunk, new_chunk, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+	{
+		//somebody else was quicker
+		free(new_chunk);
+		return chunk;
+	}
+	return new_chunk;
+}
+
+/*
+ *returns a free lid or negative if no more avail
+ *depends on USS_MAX_LOCAL_THREADS and on the lids the best
+ *encoding of this library can carry
+ *
+ *-> starts at the word of the last freed lid, so a process
+ *   that churns short jobs finds one in the first word
+ */
+int libuss_get_new_multi_table_index()
+{
+	unsigned int max_lid = USS_RTSIG_MAX_LID(USS_RTSIG_ENCODING_BEST);
+	if(max_lid > USS_MAX_LOCAL_THREADS) {max_lid = USS_MAX_LOCAL_THREADS;}
+	unsigned int nof_words = (max_lid + 63) / 64;
+	unsigned int hint = __atomic_load_n(&multi_table_hint, __ATOMIC_RELAXED);
+	if(hint >= nof_words) {hint = 0;}
+
+	for(unsigned int i = 0; i < nof_words; i++)
+	{
+		unsigned int w = (hint + i) % nof_words;
+		struct multi_table_chunk *chunk = libuss_multi_table_chunk(w / USS_MULTI_CHUNK_WORDS);
+		uint64_t *word = &chunk->used[w % USS_MULTI_CHUNK_WORDS];
+		uint64_t bits = __atomic_load_n(word, __ATOMIC_ACQUIRE);
+		while(~bits != 0)
+		{
+			int bit = __builtin_ctzll(~bits);
+			unsigned int lid = w * 64 + bit;
+			if(lid >= max_lid) {break;}
+			if(__atomic_compare_exchange_n(word, &bits, bits | ((uint64_t)1 << bit), 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			{
+				__atomic_store_n(&multi_table_hint, w, __ATOMIC_RELAXED);
+				return (int)lid;
+			}
+		}
+	}
+	return -1;
+}
+
+/*
+ *clears bit in bitmap
+ */
+void libuss_clear_multi_table_index(int x)
+{
+	if(x < 0 || x >= USS_MAX_LOCAL_THREADS) {return;}
+	struct multi_table_chunk *chunk = __atomic_load_n(&multi_table[x / USS_MULTI_CHUNK_LEN], __ATOMIC_ACQUIRE);
+	if(chunk == NULL) {return;}
+
+	int i = x % USS_MULTI_CHUNK_LEN;
+	__atomic_store_n(&chunk->local_thread[i], (pthread_t)0, __ATOMIC_RELAXED);
+	__atomic_fetch_and(&chunk->used[i / 64], ~((uint64_t)1 << (i % 64)), __ATOMIC_RELEASE);
+	__atomic_store_n(&multi_table_hint, (unsigned int)(x / 64), __ATOMIC_RELAXED);
+}
+
+/*
+ *sets/gets the local thread of a lid
+ *(0 if lid is not in use)
+ */
+static void libuss_set_multi_table_thread(int x, pthread_t thread)
+{
+	struct multi_table_chunk *chunk = libuss_multi_table_chunk(x / USS_MULTI_CHUNK_LEN);
+	__atomic_store_n(&chunk->local_thread[x % USS_MULTI_CHUNK_LEN], thread, __ATOMIC_RELEASE);
+}
+
+static pthread_t libuss_get_multi_table_thread(int x)
+{
+	if(x < 0 || x >= USS_MAX_LOCAL_THREADS) {return 0;}
+	struct multi_table_chunk *chunk = __atomic_load_n(&multi_table[x / USS_MULTI_CHUNK_LEN], __ATOMIC_ACQUIRE);
+	if(chunk == NULL) {return 0;}
+	return __atomic_load_n(&chunk->local_thread[x % USS_MULTI_CHUNK_LEN], __ATOMIC_ACQUIRE);
+}
+
+/***************************************\
+* multiplexer registration thread		*
+\***************************************/
+/*
+ * a local thread whose registration request is read (in pieces if needed)
+ */
+struct multi_connection
+{
+	ssize_t nof_br;
+	struct uss_registration_request request;
+	struct meta_sched_addr_info transport;
+};
+
+/*
+ * a registration forwarded to the daemon that waits for its reply
+ */
+struct multi_request
+{
+	int fd_localthread;
+	int local_request_id; /*id the local thread sent (put back into its reply)*/
+	int index;
+};
+
+/*
+ * the socket of the multiplexer is private to its process
+ * -> abstract address (sun_path[0] = '\0'), it goes away with the process
+ *
+ * returns the length of the address to bind/connect with
+ */
+socklen_t libuss_multiplexer_address(struct sockaddr_un *addr)
+{
+	memset(addr, 0, sizeof(struct sockaddr_un));
+	addr->sun_family = AF_UNIX;
+	int len = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1, "%s.%i", USS_REGISTRATION_MULTIPLEXER_SOCKET, (int)getpid());
+	return offsetof(struct sockaddr_un, sun_path) + 1 + len;
+}
+
+/*
+ * read (the rest of) the request of a local thread
+ *
+ * returns 1 if complete, 0 if more is to come, -1 on error
+ */
+static int multiplexer_read_local(int fd, struct multi_connection *c)
+{
+	ssize_t header_len = sizeof(struct uss_registration_request);
+	ssize_t total_len = header_len + sizeof(struct meta_sched_addr_info);
+	while(c->nof_br < total_len)
+	{
+		ssize_t nof_br;
+		if(c->nof_br < header_len) {nof_br = read(fd, ((char*)&c->request) + c->nof_br, header_len - c->nof_br);}
+		else {nof_br = read(fd, ((char*)&c->transport) + (c->nof_br - header_len), total_len - c->nof_br);}
+		if(nof_br == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {return 0;}
+		if(nof_br == -1 && errno == EINTR) {continue;}
+		if(nof_br <= 0) {return -1;}
+		c->nof_br += nof_br;
+
+		//signals are sent per thread => a request holds exactly one msai
+		if(c->nof_br == header_len && c->request.nof_msai != 1) {return -1;}
+	}
+	return 1;
+}
+
+/*
+ * append to the queue towards the daemon and send as much of it
+ * as possible without blocking
+ * -> the daemon may be busy writing replies to us, so we must not
+ *    block on it (EPOLLOUT is waited for while something is left)
+ */
+static void multiplexer_flush(int fd_daemon, int epoll_fd, vector<char> *out, size_t *out_done)
+{
+	while(*out_done < out->size())
+	{
+		ssize_t n = send(fd_daemon, &(*out)[*out_done], out->size() - *out_done, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if(n == -1 && errno == EINTR) {continue;}
+		if(n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {break;}
+		if(n <= 0) {dexit("multiplexer lost connection to daemon");}
+		*out_done += n;
+	}
+	if(*out_done == out->size()) {out->clear(); *out_done = 0;}
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = out->empty() ? EPOLLIN : (EPOLLIN | EPOLLOUT);
+	ev.data.fd = fd_daemon;
+	if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd_daemon, &ev) == -1) {dexit("epoll_ctl");}
+}
+
+/*
+ * read one reply of the daemon and hand it to the local thread
+ * (once its first bytes are there the daemon sends the rest as soon as
+ *  they fit => it is read blocking)
+ */
+static void multiplexer_reply(int fd_daemon, map<int, struct multi_request> *pending)
+{
+	struct uss_registration_reply reply;
+	struct uss_registration_response resp;
+	if(socket_transfer(fd_daemon, &reply, sizeof(struct uss_registration_reply), 0) == -1) {dexit("multiplexer lost connection to daemon");}
+	if(reply.nof_responses != 1) {dexit("multiplexer got an invalid reply");}
+	if(socket_transfer(fd_daemon, &resp, sizeof(struct uss_registration_response), 0) == -1) {dexit("multiplexer lost connection to daemon");}
+
+	map<int, struct multi_request>::iterator it = pending->find(reply.request_id);
+	if(it == pending->end()) {dexit("multiplexer got a reply to no request");}
+	struct multi_request r = (*it).second;
+	pending->erase(it);
+
+#if(USS_DEBUG == 1)			
+	printf("SCHED RESP CHECK: %i\n", resp.check);
+#endif
+
+	//
+	//write modfied reply back to local thread
+	//
+	reply.request_id = r.local_request_id;
+	resp.client_addr.pid = getpid();
+	resp.client_addr.lid = r.index;
+	if(socket_transfer(r.fd_localthread, &reply, sizeof(struct uss_registration_reply), 1) == -1 ||
+	   socket_transfer(r.fd_localthread, &resp, sizeof(struct uss_registration_response), 1) == -1)
+	{
+		derr("multiplexer could not write reply to local thread");
+	}
+	close(r.fd_localthread);
+
+	//
+	//depending on sched response, keep or clear saved state for this local thread
+	//
+	if(resp.check == USS_CONTROL_SCHED_ACCEPTED)
+	{
+	}
+	else if(resp.check == USS_CONTROL_SCHED_DECLINED || resp.check == USS_CONTROL_SCHED_RETRY)
+	{
+		libuss_clear_multi_table_index(r.index);
+	}
+	else
+	{
+		//sth odd happend
+		dexit("wrong scheduler response");
+	}
+}
+
+/*
+ *this thread hijacks outgoing registration attempts
+ *and slices in a local ID
+ *it is also a thread that can receive SIGRTMIN+0
+ *
+ *-> one connection to the daemon is kept for the whole process
+ *-> a request of a local thread is forwarded at once with an id of
+ *   the multiplexer, without waiting for the replies of the requests
+ *   before (pipelined) => the registrations of many threads end up in
+ *   the same batch of the daemon
+ *-> a reply is matched by its id and handed to its local thread
+ */
+void* libuss_registration_multiplexer_thread(void *args)
+{
+	pthread_detach(pthread_self());
+	int ret;
+	int fd_multiplexer = *(int*)args;
+	int fd_daemon, fd;
+
+	//SIGRTMIN+0 has to be unlocked
+	sigset_t unimmune_set;
+	sigemptyset(&unimmune_set);
+	sigaddset(&unimmune_set, (SIGRTMIN+0));
+	pthread_sigmask(SIG_UNBLOCK, &unimmune_set, NULL);
+
+	//
+	//persistent connection to daemon
+	//
+	struct sockaddr_un daemon_addr;
+	fd_daemon = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd_daemon == -1) {dexit("error creating socket -> quit");}
+	memset(&daemon_addr, 0, sizeof(struct sockaddr_un));
+	daemon_addr.sun_family = AF_UNIX;
+	strncpy(daemon_addr.sun_path, USS_REGISTRATION_DAEMON_SOCKET, sizeof(daemon_addr.sun_path)-1);
+	ret = connect(fd_daemon, (struct sockaddr*) &daemon_addr, sizeof(struct sockaddr_un));
+	if(ret == -1) {dexit("multiplexer could not connect to daemon -> quit");}
+
+	//
+	//wait on listening socket, local threads and daemon
+	//
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if(epoll_fd == -1) {dexit("epoll_create1");}
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = EPOLLIN;
+	ev.data.fd = fd_multiplexer;
+	if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd_multiplexer, &ev) == -1) {dexit("epoll_ctl");}
+	ev.data.fd = fd_daemon;
+	if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd_daemon, &ev) == -1) {dexit("epoll_ctl");}
+
+	map<int, struct multi_connection> locals;
+	map<int, struct multi_request> pending;
+	vector<char> out;
+	size_t out_done = 0;
+	int next_request_id = 0;
+	struct epoll_event events[USS_REGISTRATION_BATCH];
+	//
+	//loop for each batch of events
+	//
+	while(1)
+	{
+		int nof_events = epoll_wait(epoll_fd, events, USS_REGISTRATION_BATCH, -1);
+		if(nof_events == -1 && errno == EINTR) {continue;}
+		if(nof_events == -1) {dexit("multiplexer epoll_wait");}
+
+		for(int i = 0; i < nof_events; i++)
+		{
+			fd = events[i].data.fd;
+			if(fd == fd_multiplexer)
+			{
+				//accept all pending local threads
+				while((fd = accept4(fd_multiplexer, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1)
+				{
+					ev.events = EPOLLIN;
+					ev.data.fd = fd;
+					if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {dexit("epoll_ctl");}
+					locals[fd].nof_br = 0;
+				}
+				if(errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED && errno != EINTR) {dexit("multiplexer accept failed");}
+			}
+			else if(fd == fd_daemon)
+			{
+				if(events[i].events & EPOLLOUT) {multiplexer_flush(fd_daemon, epoll_fd, &out, &out_done);}
+				if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {multiplexer_reply(fd_daemon, &pending);}
+			}
+			else
+			{
+				//read (rest of) request of local thread
+				struct multi_connection *c = &locals[fd];
+				int complete = multiplexer_read_local(fd, c);
+				if(complete == 0) {continue;}
+				if(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL) == -1) {dexit("epoll_ctl");}
+				if(complete == -1) {dexit("received invalid registration request");}
+
+				//
+				//create multi_table entry
+				//
+				int index = libuss_get_new_multi_table_index();
+				if(index < 0) 
+				{
+					close(fd);
+					dexit("too many threads per process");
+				}
+				libuss_set_multi_table_thread(index, c->transport.tid);
+
+				//
+				//forward modified request to daemon (reply comes later)
+				//
+				struct multi_request r;
+				r.fd_localthread = fd;
+				r.local_request_id = c->request.request_id;
+				r.index = index;
+				c->request.request_id = next_request_id++;
+				c->transport.addr.lid = index;
+				pending[c->request.request_id] = r;
+
+				out.insert(out.end(), (char*)&c->request, (char*)&c->request + sizeof(struct uss_registration_request));
+				out.insert(out.end(), (char*)&c->transport, (char*)&c->transport + sizeof(struct meta_sched_addr_info));
+				locals.erase(fd);
+			}
+		}
+
+		//send everything forwarded in this round
+		if(!out.empty()) {multiplexer_flush(fd_daemon, epoll_fd, &out, &out_done);}
+	}//end while	
+	
+	return NULL;
+}
+
+
+/***************************************\
+* multiplexer message thread			*
+\***************************************/
+void incoming_sig_handler(int sig, siginfo_t *si, void *ucontext)
+{
+	struct uss_address addr;
+	struct uss_message mess;
+	union sigval sv = si->si_value;
+
+	//forwarded as it is => the local thread decodes it the same way
+	convert_sigval_to_uss((uint64_t)(uintptr_t)sv.sival_ptr, &addr, &mess);	
+
+	//(a late signal for a lid that has been given back is dropped)
+	pthread_t local_thread = libuss_get_multi_table_thread(addr.lid);
+	if(local_thread == 0) {return;}
+	pthread_sigqueue(local_thread, SIGRTMIN+1, sv);
+}
+
+
+/***************************************\
+* multiplexer start						*
+\***************************************/
+int libuss_start_multiplexer()
+{
+	//
+	//try to create a multiplexer socket
+	//
+	int ret;
+	ret = pthread_mutex_lock(&multiplexer_mtx);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	if(multiplexer_started == 0)
+	{
+		int ret;
+		//(read by the multiplexer thread after this function returned)
+		static int fd_multiplexer;
+		struct sockaddr_un server_addr;
+		
+		//create a socket
+		socklen_t server_addr_len = libuss_multiplexer_address(&server_addr);
+		
+		fd_multiplexer = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if(fd_multiplexer==-1) {dexit("dderror: creating socket\n");}
+		
+		ret = bind(fd_multiplexer, (struct sockaddr*) &server_addr, server_addr_len);
+		if(ret==-1) {dexit("dderror: binding socket failed\n");}
+		
+		ret = listen(fd_multiplexer, SOMAXCONN);
+		if(ret==-1) {dexit("dderror: listen on socket failed\n");}
+			
+		pthread_create(&registration_multiplexer_thread, NULL, libuss_registration_multiplexer_thread, &fd_multiplexer);
+		
+		struct sigaction sa;
+		sa.sa_flags = SA_SIGINFO | SA_RESTART;
+		sa.sa_sigaction = incoming_sig_handler;
+		sigemptyset(&sa.sa_mask);
+		ret = sigaction((SIGRTMIN+0), &sa, NULL);
+		if(ret == -1) {printf("dderror: signal int not established\n"); exit(1);}
+		
+		multiplexer_started = 1;
+	}
+	
+	ret = pthread_mutex_unlock(&multiplexer_mtx);
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return 0;
 }
\ No newline at end of file
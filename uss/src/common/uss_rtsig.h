@@ -1,44 +1,94 @@
-#ifndef RTSIG_H_INCLUDED
-#define RTSIG_H_INCLUDED
-
-#include "./uss_config.h"
-
-/*
- * a uss_message will be wrapped into a normal integer
- * using bit-operations
- * these are the bit positions
- */
-enum uss_wrapped_int_rtsig_pos
-{
-	USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS = 0,
-	USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS = 8,
-	USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS = 14,
-	USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS = 18
-};
-
-/*
- * a uss_message will be wrapped into a normal integer
- * using bit-operations
- * these are the field length
- */
-enum uss_wrapped_int_rtsig_len
-{
-	USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_LEN = 3,
-	USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_LEN = 6,
-	USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_LEN = 4,
-	USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN = 12
-};
-
-
-
-int rtsig_install_receiver(int listen_on_rtsig, int nonblock_on);
-
-void convert_uss_to_int(struct uss_address *a, struct uss_message *m, int *i);
-void convert_int_to_uss(int wrapped_int, struct uss_address *a, struct uss_message *m);
-
-int rtsig_send(int signo, pid_t receiver_pid, int data);
-ssize_t rtsig_blocking_read(int sfd, struct signalfd_siginfo *fdsi);
-
-int libuss_start_multiplexer();
-
+#ifndef RTSIG_H_INCLUDED
+#define RTSIG_H_INCLUDED
+
+#include "./uss_config.h"
+
+/*
+ * a uss_message will be wrapped into a normal integer
+ * using bit-operations
+ * these are the bit positions
+ */
+enum uss_wrapped_int_rtsig_pos
+{
+	USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_POS = 0,
+	USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_POS = 8,
+	USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_POS = 14,
+	USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_POS = 18
+};
+
+/*
+ * a uss_message will be wrapped into a normal integer
+ * using bit-operations
+ * these are the field length
+ */
+enum uss_wrapped_int_rtsig_len
+{
+	USS_WRAPPED_INT_RTSIG_MESSAGE_TYPE_LEN = 3,
+	USS_WRAPPED_INT_RTSIG_ACCEL_TYPE_LEN = 6,
+	USS_WRAPPED_INT_RTSIG_ACCEL_INDEX_LEN = 4,
+	USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN = 12
+};
+
+/*
+ * the wide encoding uses the whole 64 bit sigval (sival_ptr)
+ * -> up to 65536 accelerators per type and 16M threads per process
+ * -> the marker bit tells a receiver which encoding a value has
+ *    (a narrow value never has it set)
+ */
+enum uss_wrapped_wide_rtsig_pos
+{
+	USS_WRAPPED_WIDE_RTSIG_MESSAGE_TYPE_POS = 0,
+	USS_WRAPPED_WIDE_RTSIG_ACCEL_TYPE_POS = 8,
+	USS_WRAPPED_WIDE_RTSIG_ACCEL_INDEX_POS = 16,
+	USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_POS = 32,
+	USS_WRAPPED_WIDE_RTSIG_MARKER_POS = 63
+};
+
+enum uss_wrapped_wide_rtsig_len
+{
+	USS_WRAPPED_WIDE_RTSIG_MESSAGE_TYPE_LEN = 8,
+	USS_WRAPPED_WIDE_RTSIG_ACCEL_TYPE_LEN = 8,
+	USS_WRAPPED_WIDE_RTSIG_ACCEL_INDEX_LEN = 16,
+	USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_LEN = 24
+};
+
+/*
+ * encoding of the messages to an address (uss_address.encoding)
+ * -> a library offers the best encoding it can receive, the daemon
+ *    answers with the one both sides use (see rtsig_negotiate_encoding)
+ * -> the wide encoding needs a 64 bit sival_ptr
+ */
+enum uss_rtsig_encoding
+{
+	USS_RTSIG_ENCODING_NARROW = 0,
+	USS_RTSIG_ENCODING_WIDE = 1
+};
+
+#if(__SIZEOF_POINTER__ >= 8)
+#define USS_RTSIG_ENCODING_BEST USS_RTSIG_ENCODING_WIDE
+#else
+#define USS_RTSIG_ENCODING_BEST USS_RTSIG_ENCODING_NARROW
+#endif
+
+/*
+ * number of local thread ids an encoding can carry
+ */
+#define USS_RTSIG_MAX_LID(encoding) ((encoding) == USS_RTSIG_ENCODING_WIDE ? \
+		(1<<USS_WRAPPED_WIDE_RTSIG_LOCAL_ADDRESS_LEN) : (1<<USS_WRAPPED_INT_RTSIG_LOCAL_ADDRESS_LEN))
+
+
+int rtsig_install_receiver(int listen_on_rtsig, int nonblock_on);
+
+int rtsig_negotiate_encoding(struct uss_address *a);
+void convert_uss_to_sigval(struct uss_address *a, struct uss_message *m, union sigval *sv);
+void convert_sigval_to_uss(uint64_t value, struct uss_address *a, struct uss_message *m);
+
+int rtsig_send(int signo, pid_t receiver_pid, union sigval sv);
+ssize_t rtsig_blocking_read(int sfd, struct signalfd_siginfo *fdsi);
+ssize_t rtsig_batch_read(int sfd, struct signalfd_siginfo *fdsi, int max);
+
+socklen_t libuss_multiplexer_address(struct sockaddr_un *addr);
+void libuss_clear_multi_table_index(int x);
+int libuss_start_multiplexer();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,436 @@
+#include "./uss_config.h"
+#include "./uss_shm.h"
+#include "./uss_tools.h"
+
+/***************************************\
+* ring									*
+\***************************************/
+/*
+ * return: 0 on success, -1 if ring is full
+ */
+int shm_ring_push(struct uss_shm_ring *ring, struct uss_message *message)
+{
+	uint32_t head = ring->head;
+	uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if(head - tail >= USS_SHM_RING_LEN) {return -1;}
+
+	ring->slot[head & (USS_SHM_RING_LEN - 1)] = *message;
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/*
+ * return: 1 if a message was taken, 0 if ring is empty
+ */
+int shm_ring_pop(struct uss_shm_ring *ring, struct uss_message *message)
+{
+	uint32_t tail = ring->tail;
+	uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	if(head == tail) {return 0;}
+
+	*message = ring->slot[tail & (USS_SHM_RING_LEN - 1)];
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+/***************************************\
+* sleep and wake up						*
+\***************************************/
+/*
+ * a consumer goes to sleep in three steps:
+ * seq = shm_prepare_wait() -> check ring(s) again -> shm_wait(seq)
+ * (or shm_cancel_wait() if something arrived in the meantime)
+ *
+ * COMMENT:
+ * waiting is set before the rings are checked again and a producer checks
+ * waiting after its push (both with a full barrier)
+ * -> either the consumer sees the message or the producer sees waiting
+ *    and changes futex, so the futex wait returns at once
+ */
+uint32_t shm_prepare_wait(struct uss_shm_doorbell *doorbell)
+{
+	uint32_t seq = __atomic_load_n(&doorbell->futex, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&doorbell->waiting, 1, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	return seq;
+}
+
+void shm_cancel_wait(struct uss_shm_doorbell *doorbell)
+{
+	__atomic_store_n(&doorbell->waiting, 0, __ATOMIC_RELAXED);
+}
+
+void shm_wait(struct uss_shm_doorbell *doorbell, uint32_t seq)
+{
+	//the region is shared between processes => no FUTEX_PRIVATE_FLAG
+	//(EAGAIN: futex changed already, EINTR: signal => caller checks again)
+	syscall(SYS_futex, &doorbell->futex, FUTEX_WAIT, seq, NULL, NULL, 0);
+	__atomic_store_n(&doorbell->waiting, 0, __ATOMIC_RELAXED);
+}
+
+void shm_wake(struct uss_shm_doorbell *doorbell)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&doorbell->waiting, __ATOMIC_RELAXED) == 0) {return;}
+
+	__atomic_add_fetch(&doorbell->futex, 1, __ATOMIC_SEQ_CST);
+	syscall(SYS_futex, &doorbell->futex, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/***************************************\
+* send and receive						*
+\***************************************/
+/*
+ * push message into ring and wake up the consumer sleeping on wakeup
+ *
+ * return: 0 on success, -1 if ring is full (consumer does not read)
+ */
+int shm_send(struct uss_message *message, struct uss_shm_ring *ring, struct uss_shm_ring *wakeup)
+{
+	if(shm_ring_push(ring, message) == -1) {return -1;}
+	shm_wake(&wakeup->doorbell);
+	return 0;
+}
+
+/*
+ * take a message out of ring (the own ring is its own wakeup)
+ * -> nonblocking: returns -1 with errno EAGAIN if ring is empty
+ *
+ * return ssize_t value equal to the bytes read (like fifo_blocking_read)
+ */
+ssize_t shm_blocking_read(struct uss_message *message, struct uss_shm_ring *ring, int nonblocking)
+{
+	uint32_t seq;
+
+	if(shm_ring_pop(ring, message)) {return sizeof(struct uss_message);}
+	if(nonblocking) {errno = EAGAIN; return -1;}
+
+	while(1)
+	{
+		seq = shm_prepare_wait(&ring->doorbell);
+		if(shm_ring_pop(ring, message)) {shm_cancel_wait(&ring->doorbell); break;}
+
+		shm_wait(&ring->doorbell, seq);
+		if(shm_ring_pop(ring, message)) {break;}
+	}
+	return sizeof(struct uss_message);
+}
+
+
+#if(USS_SHM == 1)
+/***************************************\
+* fd to region							*
+\***************************************/
+/*
+ * the mapping of each region is remembered by its fd
+ * -> two level table indexed by fd (chunks allocated on first use)
+ * -> lookups need no lock (they are done on every message)
+ */
+#define USS_SHM_FD_CHUNK_LEN 1024
+#define USS_SHM_FD_DIR_LEN 64
+
+static struct uss_shm_region **shm_fd_dir[USS_SHM_FD_DIR_LEN];
+static pthread_mutex_t shm_fd_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int shm_set_region_of_fd(int fd, struct uss_shm_region *region)
+{
+	int ret;
+	if(fd < 0 || fd >= USS_SHM_FD_CHUNK_LEN * USS_SHM_FD_DIR_LEN) {return -1;}
+
+	ret = pthread_mutex_lock(&shm_fd_mutex);
+	if(ret != 0) {dexit("thread_mutex_lock");}
+
+	struct uss_shm_region **chunk = shm_fd_dir[fd / USS_SHM_FD_CHUNK_LEN];
+	if(chunk == NULL)
+	{
+		chunk = (struct uss_shm_region**) calloc(USS_SHM_FD_CHUNK_LEN, sizeof(struct uss_shm_region*));
+		if(chunk == NULL) {dexit("shm_set_region_of_fd: calloc");}
+		__atomic_store_n(&shm_fd_dir[fd / USS_SHM_FD_CHUNK_LEN], chunk, __ATOMIC_RELEASE);
+	}
+	__atomic_store_n(&chunk[fd % USS_SHM_FD_CHUNK_LEN], region, __ATOMIC_RELEASE);
+
+	ret = pthread_mutex_unlock(&shm_fd_mutex);
+	if(ret != 0) {dexit("thread_mutex_unlock");}
+	return 0;
+}
+
+/*
+ * returns the mapped region of fd or NULL
+ */
+struct uss_shm_region* shm_region_of_fd(int fd)
+{
+	if(fd < 0 || fd >= USS_SHM_FD_CHUNK_LEN * USS_SHM_FD_DIR_LEN) {return NULL;}
+
+	struct uss_shm_region **chunk = __atomic_load_n(&shm_fd_dir[fd / USS_SHM_FD_CHUNK_LEN], __ATOMIC_ACQUIRE);
+	if(chunk == NULL) {return NULL;}
+	return __atomic_load_n(&chunk[fd % USS_SHM_FD_CHUNK_LEN], __ATOMIC_ACQUIRE);
+}
+
+/***************************************\
+* installation 							*
+\***************************************/
+/*
+ * map the region of fd and remember it
+ *
+ * returns fd or -1 on error
+ */
+static int shm_map(int fd)
+{
+	void *ptr = mmap(NULL, sizeof(struct uss_shm_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(ptr == MAP_FAILED) {derr("shm_map: mmap"); close(fd); return -1;}
+
+	if(shm_set_region_of_fd(fd, (struct uss_shm_region*)ptr) == -1)
+	{
+		derr("shm_map: fd too large");
+		munmap(ptr, sizeof(struct uss_shm_region));
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/*
+ * to create and map a new shared memory region
+ * and store created regions index to addr->shm
+ * (like fifo_install_receiver)
+ *
+ * returns fd or -1 on error
+ */
+int shm_install_receiver(struct uss_address *addr)
+{
+	static long shm_counter = 0;
+	int ret, fd = -1;
+	char shm_name[USS_SHM_NAME_LEN];
+	long shm_index;
+	if(addr->shm == 0)
+	{
+		//create new region, named unique like the channels of fifo_install_receiver
+		long counter = __sync_add_and_fetch(&shm_counter, 1);
+		shm_index = ((long)getpid() << 32) | (counter & 0xffffffff);
+
+		snprintf(shm_name, USS_SHM_NAME_LEN, USS_SHM_NAME_TEMPLATE, shm_index);
+		shm_unlink(shm_name); /*left over by a dead process with the same pid*/
+
+		fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if(fd == -1) {dexit("shm_install_receiver: shm_open");}
+	}
+	else
+	{
+		//create specific new region depending value currently inside of addr->shm
+		snprintf(shm_name, USS_SHM_NAME_LEN, USS_SHM_NAME_TEMPLATE, addr->shm);
+		shm_unlink(shm_name);
+
+		shm_index = addr->shm;
+
+		fd = shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if(fd == -1) {dexit("shm_install_receiver: failed to shm_open with specific name");}
+	}
+
+	//a new region is zero filled => rings are empty
+	ret = ftruncate(fd, sizeof(struct uss_shm_region));
+	if(ret == -1) {dexit("shm_install_receiver: ftruncate");}
+
+#if(USS_DEBUG == 1)
+	printf("install_receiver on shm %s\n", shm_name);
+#endif
+	fd = shm_map(fd);
+	if(fd == -1) {return -1;}
+	shm_region_of_fd(fd)->id = shm_index;
+
+	addr->shm = shm_index;
+	return fd;
+}
+
+/*
+ * map the region specified in addr
+ *
+ * returns fd or -1 on error
+ */
+int shm_install_sender(struct uss_address *addr)
+{
+	char shm_name[USS_SHM_NAME_LEN];
+	snprintf(shm_name, USS_SHM_NAME_LEN, USS_SHM_NAME_TEMPLATE, addr->shm);
+
+#if(USS_DEBUG == 1)
+	printf("install_sender on shm %s\n", shm_name);
+#endif
+	int fd = shm_open(shm_name, O_RDWR, 0);
+	if(fd == -1) {derr("shm_install_sender: prob when shm_open"); return -1;}
+	return shm_map(fd);
+}
+
+/*
+ * unmap region of fd and close fd
+ * (do_unlink: the creator also removes the name)
+ *
+ * returns 0 on success or -1 on error
+ */
+int shm_uninstall(int fd, int do_unlink)
+{
+	struct uss_shm_region *region = shm_region_of_fd(fd);
+	if(region == NULL) {return -1;}
+
+	if(do_unlink)
+	{
+		char shm_name[USS_SHM_NAME_LEN];
+		snprintf(shm_name, USS_SHM_NAME_LEN, USS_SHM_NAME_TEMPLATE, region->id);
+		shm_unlink(shm_name);
+	}
+
+	shm_set_region_of_fd(fd, NULL);
+	munmap(region, sizeof(struct uss_shm_region));
+	return close(fd);
+}
+#endif
+
+
+#if(USS_SHARED_RUN_ON == 1)
+/***************************************\
+* shared run_on slot					*
+\***************************************/
+/*
+ * the slot of a client thread is named after its address
+ * (RTSIG: after its own id, the lid is assigned by the multiplexer
+ *  only after the slot has been created)
+ */
+static void runon_name_of_address(struct uss_address *addr, char *runon_name)
+{
+	long key;
+#if(USS_FIFO == 1)
+	key = addr->fifo;
+#elif(USS_RTSIG == 1)
+	key = ((long)addr->pid << 32) | (addr->runon & 0xffffffff);
+#elif(USS_SHM == 1)
+	key = addr->shm;
+#endif
+	snprintf(runon_name, USS_RUNON_NAME_LEN, USS_RUNON_NAME_TEMPLATE, key);
+}
+
+static struct uss_runon_slot* runon_map(int fd)
+{
+	void *ptr = mmap(NULL, sizeof(struct uss_runon_slot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); //mapping stays valid
+	if(ptr == MAP_FAILED) {derr("runon_map: mmap"); return NULL;}
+	return (struct uss_runon_slot*)ptr;
+}
+
+/*
+ * create the slot of the (already installed) receiver addr
+ * (a new slot is zero filled => decision is USS_ACCEL_TYPE_IDLE)
+ *
+ * returns slot or NULL on error
+ */
+struct uss_runon_slot* runon_install_receiver(struct uss_address *addr)
+{
+#if(USS_RTSIG == 1)
+	static long runon_counter = 0;
+	if(addr->runon == 0) {addr->runon = __sync_add_and_fetch(&runon_counter, 1);}
+#endif
+	char runon_name[USS_RUNON_NAME_LEN];
+	runon_name_of_address(addr, runon_name);
+	shm_unlink(runon_name);
+
+	int fd = shm_open(runon_name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if(fd == -1) {derr("runon_install_receiver: shm_open"); return NULL;}
+
+	if(ftruncate(fd, sizeof(struct uss_runon_slot)) == -1)
+	{
+		derr("runon_install_receiver: ftruncate");
+		close(fd);
+		shm_unlink(runon_name);
+		return NULL;
+	}
+	return runon_map(fd);
+}
+
+/*
+ * map the slot created by the library of addr
+ *
+ * returns slot or NULL on error
+ */
+struct uss_runon_slot* runon_install_sender(struct uss_address *addr)
+{
+	char runon_name[USS_RUNON_NAME_LEN];
+	runon_name_of_address(addr, runon_name);
+
+	int fd = shm_open(runon_name, O_RDWR, 0);
+	if(fd == -1) {derr("runon_install_sender: shm_open"); return NULL;}
+	return runon_map(fd);
+}
+
+/*
+ * (do_unlink: the creator also removes the name)
+ *
+ * returns 0 on success or -1 on error
+ */
+int runon_uninstall(struct uss_runon_slot *slot, struct uss_address *addr, int do_unlink)
+{
+	if(do_unlink)
+	{
+		char runon_name[USS_RUNON_NAME_LEN];
+		runon_name_of_address(addr, runon_name);
+		shm_unlink(runon_name);
+	}
+	return munmap(slot, sizeof(struct uss_runon_slot));
+}
+
+/*
+ * daemon: replace the decision and wake up the library if it sleeps
+ */
+void runon_publish(struct uss_runon_slot *slot, int accelerator_type, int accelerator_index)
+{
+	uint64_t decision = ((uint64_t)(uint32_t)accelerator_type << 32) | (uint32_t)accelerator_index;
+	__atomic_store_n(&slot->decision, decision, __ATOMIC_RELEASE);
+	shm_wake(&slot->doorbell);
+}
+
+/*
+ * library: read the latest decision (no syscall)
+ */
+void runon_load(struct uss_runon_slot *slot, int *accelerator_type, int *accelerator_index)
+{
+	uint64_t decision = __atomic_load_n(&slot->decision, __ATOMIC_ACQUIRE);
+	*accelerator_type = (int)(uint32_t)(decision >> 32);
+	*accelerator_index = (int)(uint32_t)decision;
+}
+
+/*
+ * library: sleep until the decision differs from the given one
+ */
+void runon_wait_change(struct uss_runon_slot *slot, int accelerator_type, int accelerator_index)
+{
+	int type, index;
+	uint32_t seq;
+
+	while(1)
+	{
+		seq = shm_prepare_wait(&slot->doorbell);
+		runon_load(slot, &type, &index);
+		if(type != accelerator_type || index != accelerator_index) {shm_cancel_wait(&slot->doorbell); return;}
+
+		shm_wait(&slot->doorbell, seq);
+	}
+}
+
+/*
+ * library: have decisions sent over the channel as well
+ * -> the library loads the decision after this, so a decision is
+ *    either seen in the slot or sent over the channel
+ *   (store and load are ordered against the ones of runon_publish)
+ */
+void runon_set_notify(struct uss_runon_slot *slot)
+{
+	__atomic_store_n(&slot->notify, 1, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*
+ * daemon: returns 1 if the decision just published has to be sent
+ * over the channel as well
+ */
+int runon_get_notify(struct uss_runon_slot *slot)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	return (int)__atomic_load_n(&slot->notify, __ATOMIC_SEQ_CST);
+}
+#endif
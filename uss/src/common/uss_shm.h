@@ -0,0 +1,103 @@
+#ifndef SHM_H_INCLUDED
+#define SHM_H_INCLUDED
+
+#include "./uss_config.h"
+
+/***************************************\
+* shared memory rings					*
+\***************************************/
+/*
+ * doorbell a consumer sleeps on
+ * -> it announces with waiting that it sleeps on futex, so a producer
+ *    only needs a syscall (futex wake) if its peer is sleeping
+ */
+struct uss_shm_doorbell
+{
+	uint32_t waiting;
+	uint32_t futex;
+};
+
+/*
+ * lock-free single producer single consumer ring of messages
+ * -> head is only written by the producer, tail only by the consumer
+ * -> doorbell belongs to the consumer
+ */
+struct uss_shm_ring
+{
+	uint32_t head;
+	char pad_head[60];
+	uint32_t tail;
+	char pad_tail[60];
+	struct uss_shm_doorbell doorbell;
+	char pad_doorbell[56];
+	struct uss_message slot[USS_SHM_RING_LEN];
+};
+
+/*
+ * a region is shared by the daemon and one client thread
+ *
+ * COMMENT:
+ * the daemon has a region of its own, but it only uses to_daemon.doorbell
+ * of it as the doorbell every client rings after pushing into the
+ * to_daemon ring of its own region
+ */
+struct uss_shm_region
+{
+	long id;
+	char pad_id[56];
+	struct uss_shm_ring to_client;
+	struct uss_shm_ring to_daemon;
+};
+
+/***************************************\
+* shared run_on slot					*
+\***************************************/
+/*
+ * latest run_on decision of the daemon for one client thread
+ * -> decision packs accelerator type (high) and index (low) so both
+ *    change with a single store
+ * -> a decision the library did not see in time is replaced by the next
+ *   (fine, the daemon waits for the CLEANUP_DONE of a preempted job
+ *    before it decides on its accelerator again)
+ * -> doorbell belongs to the library: it sleeps there while IDLE
+ * -> notify is set by a library that waits on the channel of the
+ *    job instead (executor of submitted jobs), the daemon then
+ *    sends each decision over the channel as well
+ */
+struct uss_runon_slot
+{
+	uint64_t decision;
+	struct uss_shm_doorbell doorbell;
+	uint32_t notify;
+};
+
+int shm_ring_push(struct uss_shm_ring *ring, struct uss_message *message);
+int shm_ring_pop(struct uss_shm_ring *ring, struct uss_message *message);
+
+uint32_t shm_prepare_wait(struct uss_shm_doorbell *doorbell);
+void shm_cancel_wait(struct uss_shm_doorbell *doorbell);
+void shm_wait(struct uss_shm_doorbell *doorbell, uint32_t seq);
+void shm_wake(struct uss_shm_doorbell *doorbell);
+
+int shm_send(struct uss_message *message, struct uss_shm_ring *ring, struct uss_shm_ring *wakeup);
+ssize_t shm_blocking_read(struct uss_message *message, struct uss_shm_ring *ring, int nonblocking);
+
+#if(USS_SHM == 1)
+int shm_install_receiver(struct uss_address *addr);
+int shm_install_sender(struct uss_address *addr);
+int shm_uninstall(int fd, int do_unlink);
+struct uss_shm_region* shm_region_of_fd(int fd);
+#endif
+
+#if(USS_SHARED_RUN_ON == 1)
+struct uss_runon_slot* runon_install_receiver(struct uss_address *addr);
+struct uss_runon_slot* runon_install_sender(struct uss_address *addr);
+int runon_uninstall(struct uss_runon_slot *slot, struct uss_address *addr, int do_unlink);
+void runon_publish(struct uss_runon_slot *slot, int accelerator_type, int accelerator_index);
+void runon_load(struct uss_runon_slot *slot, int *accelerator_type, int *accelerator_index);
+void runon_wait_change(struct uss_runon_slot *slot, int accelerator_type, int accelerator_index);
+void runon_set_notify(struct uss_runon_slot *slot);
+int runon_get_notify(struct uss_runon_slot *slot);
+#endif
+
+#endif
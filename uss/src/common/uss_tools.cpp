@@ -1,37 +1,58 @@
-#include "./uss_tools.h"
-
-void derr(const char *format)
-{
-	printf("(derror) ");
-	printf("%s", format);
-	printf(" errno=(%s)\n", strerror(errno));
-}
-
-
-void dexit(const char *format)
-{
-	printf("(derror) ");
-	printf("%s", format);
-	printf(" errno=(%s)\n", strerror(errno));
-	exit(-1);
-}
-
-/*
- * dbug: print a struct meta_sched_info_short
- */
-void print_msai(struct meta_sched_addr_info* msai)
-{
-	//validity check
-	if(!msai) return;
-	//print
-	printf("printing struct meta_sched_info_short of pid: %i and length: %i\n", msai->addr.pid, msai->length);
-	int i;
-	for(i = 0; i < USS_MAX_MSI_TRANSPORT && i < msai->length; i++)
-	{
-		printf("type: %i affinity: %i flags: %i \n", 
-				msai->accelerator_type[i],
-				msai->affinity[i],
-				msai->flags[i]);
-	}
-	printf("\n");
-}
+#include "./uss_tools.h"
+
+void derr(const char *format)
+{
+	printf("(derror) ");
+	printf("%s", format);
+	printf(" errno=(%s)\n", strerror(errno));
+}
+
+
+void dexit(const char *format)
+{
+	printf("(derror) ");
+	printf("%s", format);
+	printf(" errno=(%s)\n", strerror(errno));
+	exit(-1);
+}
+
+/*
+ * dbug: print a struct meta_sched_info_short
+ */
+void print_msai(struct meta_sched_addr_info* msai)
+{
+	//validity check
+	if(!msai) return;
+	//print
+	printf("printing struct meta_sched_info_short of pid: %i and length: %i nice: %i\n", msai->addr.pid, msai->length, msai->nice);
+	int i;
+	for(i = 0; i < USS_MAX_MSI_TRANSPORT && i < msai->length; i++)
+	{
+		printf("type: %i affinity: %i flags: %i \n", 
+				msai->accelerator_type[i],
+				msai->affinity[i],
+				msai->flags[i]);
+	}
+	printf("\n");
+}
+
+/*
+ * reads or writes exactly len bytes on a blocking fd
+ * (a registration request or reply may come in pieces)
+ *
+ * returns 0 on success, -1 if the peer went away
+ */
+int socket_transfer(int fd, void *buf, size_t len, int do_write)
+{
+	size_t done = 0;
+	while(done < len)
+	{
+		ssize_t size_ret;
+		if(do_write) {size_ret = send(fd, ((char*)buf) + done, len - done, MSG_NOSIGNAL);}
+		else {size_ret = read(fd, ((char*)buf) + done, len - done);}
+		if(size_ret == -1 && errno == EINTR) {continue;}
+		if(size_ret <= 0) {return -1;}
+		done += size_ret;
+	}
+	return 0;
+}
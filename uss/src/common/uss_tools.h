@@ -1,12 +1,14 @@
-#ifndef TOOLS_H_INCLUDED
-#define TOOLS_H_INCLUDED
-
-#include "./uss_config.h"
-
-void derr(const char *format);
-
-void dexit(const char *format);
-
-void print_msai(struct meta_sched_addr_info* msi_short);
-
+#ifndef TOOLS_H_INCLUDED
+#define TOOLS_H_INCLUDED
+
+#include "./uss_config.h"
+
+void derr(const char *format);
+
+void dexit(const char *format);
+
+void print_msai(struct meta_sched_addr_info* msi_short);
+
+int socket_transfer(int fd, void *buf, size_t len, int do_write);
+
 #endif
\ No newline at end of file
@@ -1,204 +1,490 @@
-#include "./uss_daemon.h"
-#include "../common/uss_tools.h"
-#include "../common/uss_rtsig.h"
-#include "../common/uss_fifo.h"
-#include "./uss_comm_controller.h"
-#include "./uss_registration_controller.h"
-#include "./uss_scheduler.h"
-
-using namespace std;
-
-//////////////////////////////////////////////
-//											//
-// class uss_communication_controller		//
-// interface definitions					//
-//											//
-//////////////////////////////////////////////
-
-/***************************************\
-* constructor and destructor			*
-\***************************************/
-uss_comm_controller::uss_comm_controller() 
-{
-#if(USS_FIFO == 1)
-	if(pthread_mutex_init(&this->fifo_mutex, NULL) != 0) {printf("error with mutex init\n"); exit(-1);}
-#endif
-}
-
-uss_comm_controller::~uss_comm_controller()
-{
-#if(USS_FIFO == 1)
-	pthread_mutex_destroy(&this->fifo_mutex);
-#endif
-}
-
-/***************************************\
-* helper								*
-\***************************************/
-#if(USS_FIFO == 1)
-/* 
- *returns searched fd on success
- */
-int uss_comm_controller::get_fd_of_address(struct uss_address addr)
-{
-	int ret, final_ret;
-	ret = pthread_mutex_lock(&(this->fifo_mutex));
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	uss_fifo_list_iterator selected_fifo_list_element = this->fifo_list.find(addr);
-	if(selected_fifo_list_element == this->fifo_list.end()) {dexit("get_fd_of_address: not found but has to be there");}
-	
-	final_ret = (*selected_fifo_list_element).second;
-	
-	ret = pthread_mutex_unlock(&(this->fifo_mutex));
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	return final_ret;
-}
-
-/*
- *returns 0 on success
- */
-int uss_comm_controller::delete_fd_of_address(struct uss_address addr)
-{
-	int ret;
-	ret = pthread_mutex_lock(&(this->fifo_mutex));
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	uss_fifo_list_iterator selected_fifo_list_element = this->fifo_list.find(addr);
-	if(selected_fifo_list_element == this->fifo_list.end()) {dexit("delete_fd_of_address: not found but has to be there");}
-	
-	this->fifo_list.erase(selected_fifo_list_element);
-	
-	ret = pthread_mutex_unlock(&(this->fifo_mutex));
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	return 0;
-}
-#endif
-/***************************************\
-* installation (make any T a listener)	*
-\***************************************/
-/*
- * to create and obtain a new NONBLOCKING signal file descriptor
- * or create and open fifo
- *
- * (!) RTSIG: this will block SIGRTMIN for this thread only
- *
- * returns fd on success or -1 on error
- */
-int uss_comm_controller::install_receiver(struct uss_address *addr)
-{
-#if(USS_FIFO == 1)
-	return fifo_install_receiver(addr, 1, 0, 0);
-#elif(USS_RTSIG == 1)
-	//create blocking sig fd that listens on SIGRTMIN+0 
-	return rtsig_install_receiver(0, 0);
-#endif
-
-}
-
-/*
- * to open fifo and gets a fd (and also memorizes it!)
- *
- * (!) RTSIG: this will block SIGRTMIN for this thread only
- *
- * returns fd on success or -1 on error
- */
-int uss_comm_controller::install_sender(struct uss_address *addr)
-{
-#if(USS_FIFO == 1)
-	//get fd
-	int ret;
-	int fd = fifo_install_sender(addr, 0, 1, 0);
-	if(fd == -1) {dexit("install_sender: failed");}
-	
-	ret = pthread_mutex_lock(&(this->fifo_mutex));
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	this->fifo_list.insert(make_pair(*addr, fd));
-	
-	ret = pthread_mutex_unlock(&(this->fifo_mutex));
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	return fd;
-#elif(USS_RTSIG == 1)
-	//no need for a senderobject, signals can be simply send away
-	return 0;
-#endif	
-}
-
-/* 
- * when work is finished call this to terminate a connection
- *
- * returns 0 on success or -1 on error
- */
-int uss_comm_controller::uninstall_sender(struct uss_address *addr)
-{
-#if(USS_FIFO == 1)
-	return close(get_fd_of_address((*addr)));
-#elif(USS_RTSIG == 1)
-	//no need for a senderobject, signals can be simply send away
-	return 0;
-#endif	
-}
-
-
-/***************************************\
-* message send/receive GENERIC public	*
-\***************************************/
-/*(public)
- * send a message
- *
- * uses send_rtsig
- */
-int uss_comm_controller::send(struct uss_address receiver_address, struct uss_message message)
-{
-	int ret;
-#if(USS_DAEMON_DEBUG == 1)
-	//printf("-><- cc is sending message\n");
-#endif
-#if(USS_FIFO == 1)	
-	ret = fifo_send(&message, get_fd_of_address(receiver_address));
-#elif(USS_RTSIG == 1)	
-	//wraps struct uss_message into a single int value
-	int wrapped_int = 0;
-	convert_uss_to_int(&receiver_address, &message, &wrapped_int);
-	
-	//send to pid (other part of uss_address is wrapped into int)
-	ret = rtsig_send(0, receiver_address.pid, wrapped_int);
-#endif
-	return ret;
-}
-
-/*(public)
- * blocking receive
- *
- * can be awakend by a FLUSH
- *
- * uses blocking_read_rtsig
- * return: 0 on success, -1 on error
- */
-int uss_comm_controller::blocking_read(int target_fd, struct uss_address *received_address, struct uss_message *message)
-{
-	int final_ret = -1;
-#if(USS_FIFO == 1)	
-	ssize_t read_size = fifo_blocking_read(message, target_fd);
-	if(read_size != sizeof(struct uss_message)) dexit("blocking_read: read_size != so(mess)");
-	else final_ret = 0;
-	
-	*received_address = message->address;
-#elif(USS_RTSIG == 1)	
-	//do the read
-	struct signalfd_siginfo fdsi;
-	ssize_t read_size = rtsig_blocking_read(target_fd, &fdsi);
-	if(read_size != sizeof(struct signalfd_siginfo)) dexit("blocking_read: read_size != so(fdsi)");
-	else final_ret = 0;
-	
-	//fdsi.ssi_int => unwrap int value into struct uss_message
-	convert_int_to_uss(fdsi.ssi_int, received_address, message);
-	//fdsi.ssi_pid => put into address
-	received_address->pid = fdsi.ssi_pid;
-#endif	
-	return final_ret;
-}
+#include "./uss_daemon.h"
+#include "../common/uss_tools.h"
+#include "../common/uss_rtsig.h"
+#include "../common/uss_fifo.h"
+#include "../common/uss_shm.h"
+#include "./uss_comm_controller.h"
+#include "./uss_registration_controller.h"
+#include "./uss_scheduler.h"
+
+using namespace std;
+
+//////////////////////////////////////////////
+//											//
+// class uss_communication_controller		//
+// interface definitions					//
+//											//
+//////////////////////////////////////////////
+
+/***************************************\
+* constructor and destructor			*
+\***************************************/
+uss_comm_controller::uss_comm_controller() 
+{
+#if(USS_FIFO == 1 || USS_SHM == 1)
+	if(pthread_mutex_init(&this->fifo_mutex, NULL) != 0) {printf("error with mutex init\n"); exit(-1);}
+#endif
+#if(USS_FIFO == 1)
+	//channel of the daemon exists before the first registration is answered
+	memset(&this->fifo_daemon_addr, 0, sizeof(struct uss_address));
+	this->fifo_daemon_addr.fifo = 1;
+	this->fifo_daemon_receiver = fifo_install_receiver(&this->fifo_daemon_addr, &this->fifo_daemon_sender, 0);
+	if(this->fifo_daemon_receiver == -1) {printf("error with daemon channel\n"); exit(-1);}
+#endif
+#if(USS_SHM == 1)
+	this->shm_daemon = NULL;
+	this->shm_next = 0;
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+	if(pthread_mutex_init(&this->runon_mutex, NULL) != 0) {printf("error with mutex init\n"); exit(-1);}
+#endif
+}
+
+uss_comm_controller::~uss_comm_controller()
+{
+#if(USS_FIFO == 1 || USS_SHM == 1)
+	pthread_mutex_destroy(&this->fifo_mutex);
+#endif
+#if(USS_FIFO == 1)
+	close(this->fifo_daemon_receiver);
+	close(this->fifo_daemon_sender);
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+	pthread_mutex_destroy(&this->runon_mutex);
+#endif
+}
+
+/***************************************\
+* helper								*
+\***************************************/
+#if(USS_FIFO == 1)
+/*
+ * write end of the channel of the daemon
+ * (its own write end keeps the channel open if no library is left)
+ */
+int uss_comm_controller::get_daemon_sender()
+{
+	return this->fifo_daemon_sender;
+}
+#endif
+
+#if(USS_FIFO == 1 || USS_SHM == 1)
+/* 
+ *returns searched fd on success
+ */
+int uss_comm_controller::get_fd_of_address(struct uss_address addr)
+{
+	int ret, final_ret;
+	ret = pthread_mutex_lock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	uss_fifo_list_iterator selected_fifo_list_element = this->fifo_list.find(addr);
+	if(selected_fifo_list_element == this->fifo_list.end()) {dexit("get_fd_of_address: not found but has to be there");}
+	
+	final_ret = (*selected_fifo_list_element).second;
+	
+	ret = pthread_mutex_unlock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return final_ret;
+}
+
+/*
+ *returns 0 on success
+ */
+int uss_comm_controller::delete_fd_of_address(struct uss_address addr)
+{
+	int ret;
+	ret = pthread_mutex_lock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	uss_fifo_list_iterator selected_fifo_list_element = this->fifo_list.find(addr);
+	if(selected_fifo_list_element == this->fifo_list.end()) {dexit("delete_fd_of_address: not found but has to be there");}
+	
+	this->fifo_list.erase(selected_fifo_list_element);
+	
+	ret = pthread_mutex_unlock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return 0;
+}
+#endif
+#if(USS_SHM == 1)
+/*
+ * take messages out of the to_daemon rings of all clients
+ * (starting with another client each time to be fair)
+ *
+ * returns number of messages taken
+ */
+int uss_comm_controller::shm_drain(struct uss_message *messages, int max)
+{
+	int ret, nof_messages = 0;
+	ret = pthread_mutex_lock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	unsigned int nof_clients = this->shm_clients.size();
+	for(unsigned int i = 0; i < nof_clients && nof_messages < max; i++)
+	{
+		struct uss_shm_region *region = this->shm_clients[(this->shm_next + i) % nof_clients];
+		while(nof_messages < max && shm_ring_pop(&region->to_daemon, &messages[nof_messages])) {nof_messages++;}
+	}
+	this->shm_next++;
+	
+	ret = pthread_mutex_unlock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return nof_messages;
+}
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+/*
+ * returns run_on slot of addr or NULL if it is not installed (any more)
+ */
+struct uss_runon_slot* uss_comm_controller::get_runon_slot_of_address(struct uss_address addr)
+{
+	int ret;
+	struct uss_runon_slot *slot = NULL;
+	ret = pthread_mutex_lock(&(this->runon_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	uss_runon_list_iterator selected_runon_list_element = this->runon_list.find(addr);
+	if(selected_runon_list_element != this->runon_list.end()) {slot = (*selected_runon_list_element).second;}
+	
+	ret = pthread_mutex_unlock(&(this->runon_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return slot;
+}
+
+/*
+ *returns 0 on success
+ */
+int uss_comm_controller::add_runon_slot_of_address(struct uss_address addr, struct uss_runon_slot *slot)
+{
+	int ret;
+	ret = pthread_mutex_lock(&(this->runon_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	this->runon_list.insert(make_pair(addr, slot));
+	
+	ret = pthread_mutex_unlock(&(this->runon_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return 0;
+}
+
+/*
+ *returns the removed slot (to unmap it)
+ */
+struct uss_runon_slot* uss_comm_controller::delete_runon_slot_of_address(struct uss_address addr)
+{
+	int ret;
+	ret = pthread_mutex_lock(&(this->runon_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	uss_runon_list_iterator selected_runon_list_element = this->runon_list.find(addr);
+	if(selected_runon_list_element == this->runon_list.end()) {dexit("delete_runon_slot_of_address: not found but has to be there");}
+	
+	struct uss_runon_slot *slot = (*selected_runon_list_element).second;
+	this->runon_list.erase(selected_runon_list_element);
+	
+	ret = pthread_mutex_unlock(&(this->runon_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return slot;
+}
+#endif
+/***************************************\
+* installation (make any T a listener)	*
+\***************************************/
+/*
+ * to create and obtain a new NONBLOCKING signal file descriptor
+ * or return the channel of the daemon (FIFO)
+ *
+ * (!) RTSIG: this will block SIGRTMIN for this thread only
+ *
+ * returns fd on success or -1 on error
+ */
+int uss_comm_controller::install_receiver(struct uss_address *addr)
+{
+#if(USS_FIFO == 1)
+	//created in the constructor
+	*addr = this->fifo_daemon_addr;
+	return this->fifo_daemon_receiver;
+#elif(USS_RTSIG == 1)
+	//create blocking sig fd that listens on SIGRTMIN+0 
+	return rtsig_install_receiver(0, 0);
+#elif(USS_SHM == 1)
+	//region of the daemon (only its doorbell is used)
+	int fd = shm_install_receiver(addr);
+	if(fd == -1) {return -1;}
+	this->shm_daemon = shm_region_of_fd(fd);
+	return fd;
+#endif
+
+}
+
+/*
+ * to memorize the channel (FIFO: passed by the library on
+ * registration, ignored otherwise) or map the region of addr
+ *
+ * (!) RTSIG: this will block SIGRTMIN for this thread only
+ *
+ * returns fd on success or -1 on error
+ */
+int uss_comm_controller::install_sender(struct uss_address *addr, int channel)
+{
+#if(USS_FIFO == 1)
+	int ret;
+	int fd = channel;
+	if(fd == -1) {dexit("install_sender: failed");}
+	
+	ret = pthread_mutex_lock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	this->fifo_list.insert(make_pair(*addr, fd));
+	
+	ret = pthread_mutex_unlock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return fd;
+#elif(USS_RTSIG == 1)
+	//no need for a senderobject, signals can be simply send away
+	return 0;
+#elif(USS_SHM == 1)
+	//map region created by library
+	int ret;
+	int fd = shm_install_sender(addr);
+	if(fd == -1) {dexit("install_sender: failed");}
+	
+	ret = pthread_mutex_lock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	this->fifo_list.insert(make_pair(*addr, fd));
+	this->shm_clients.push_back(shm_region_of_fd(fd));
+	
+	ret = pthread_mutex_unlock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	return fd;
+#endif	
+}
+
+/* 
+ * when work is finished call this to terminate a connection
+ *
+ * returns 0 on success or -1 on error
+ */
+int uss_comm_controller::uninstall_sender(struct uss_address *addr)
+{
+#if(USS_FIFO == 1)
+	int fd = get_fd_of_address((*addr));
+	delete_fd_of_address((*addr));
+	return close(fd);
+#elif(USS_RTSIG == 1)
+	//no need for a senderobject, signals can be simply send away
+	return 0;
+#elif(USS_SHM == 1)
+	//dispatcher thread must not drain this region any more
+	int ret;
+	ret = pthread_mutex_lock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	uss_fifo_list_iterator selected_fifo_list_element = this->fifo_list.find(*addr);
+	if(selected_fifo_list_element == this->fifo_list.end()) {dexit("uninstall_sender: not found but has to be there");}
+	int fd = (*selected_fifo_list_element).second;
+	this->fifo_list.erase(selected_fifo_list_element);
+	
+	struct uss_shm_region *region = shm_region_of_fd(fd);
+	for(unsigned int i = 0; i < this->shm_clients.size(); i++)
+	{
+		if(this->shm_clients[i] == region) 
+		{
+			this->shm_clients[i] = this->shm_clients.back();
+			this->shm_clients.pop_back();
+			break;
+		}
+	}
+	
+	ret = pthread_mutex_unlock(&(this->fifo_mutex));
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	//library removes the name of its region
+	return shm_uninstall(fd, 0);
+#endif	
+}
+
+
+#if(USS_SHARED_RUN_ON == 1)
+/*
+ * map the run_on slot created by the library of a client thread
+ * (RUNON messages to addr are published there from now on)
+ *
+ * returns 0 on success or -1 on error
+ */
+int uss_comm_controller::install_runon_slot(struct uss_address *addr)
+{
+	struct uss_runon_slot *slot = runon_install_sender(addr);
+	if(slot == NULL) {return -1;}
+	return add_runon_slot_of_address(*addr, slot);
+}
+
+/*
+ * returns 0 on success or -1 on error
+ */
+int uss_comm_controller::uninstall_runon_slot(struct uss_address *addr)
+{
+	//library removes the name of its slot
+	return runon_uninstall(delete_runon_slot_of_address(*addr), addr, 0);
+}
+#endif
+
+/***************************************\
+* message send/receive GENERIC public	*
+\***************************************/
+/*(public)
+ * resolve everything needed to send to addr (lookups once)
+ * -> sender and run_on slot of addr have to be installed
+ *
+ * return: 0 on success, -1 on error
+ */
+int uss_comm_controller::get_channel_of_address(struct uss_address addr, struct uss_channel *channel)
+{
+	memset(channel, 0, sizeof(struct uss_channel));
+	channel->addr = addr;
+	channel->fd = -1;
+#if(USS_FIFO == 1 || USS_SHM == 1)
+	channel->fd = get_fd_of_address(addr);
+#endif
+#if(USS_SHM == 1)
+	channel->region = shm_region_of_fd(channel->fd);
+	if(channel->region == NULL) {return -1;}
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+	channel->slot = get_runon_slot_of_address(addr);
+	if(channel->slot == NULL) {return -1;}
+#endif
+	return 0;
+}
+
+/*(public)
+ * send a message over a channel (no lookup, no lock)
+ *
+ * uses send_rtsig
+ */
+int uss_comm_controller::send(struct uss_channel *channel, struct uss_message message)
+{
+	int ret;
+#if(USS_DAEMON_DEBUG == 1)
+	//printf("-><- cc is sending message\n");
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+	//run_on decisions are published into the slot (no syscall)
+	//(-1: application already finished and its slot is gone)
+	if(message.message_type == USS_MESSAGE_RUNON)
+	{
+		if(channel->slot == NULL) {return -1;}
+		runon_publish(channel->slot, message.accelerator_type, message.accelerator_index);
+		//(the library waits on the channel => send it there as well)
+		if(!runon_get_notify(channel->slot)) {return 0;}
+	}
+#endif
+#if(USS_FIFO == 1)	
+	ret = fifo_send(&message, channel->fd);
+#elif(USS_RTSIG == 1)	
+	//wraps struct uss_message into a single sigval (encoding negotiated on registration)
+	union sigval sv;
+	convert_uss_to_sigval(&channel->addr, &message, &sv);
+	
+	//send to pid (other part of uss_address is wrapped into sigval)
+	ret = rtsig_send(0, channel->addr.pid, sv);
+#elif(USS_SHM == 1)
+	//-1: ring full => application does not read any more
+	ret = shm_send(&message, &channel->region->to_client, &channel->region->to_client);
+#endif
+	return ret;
+}
+
+/*(public)
+ * blocking receive
+ *
+ * can be awakend by a FLUSH
+ *
+ * uses blocking_read_rtsig
+ * return: 0 on success, -1 on error
+ */
+int uss_comm_controller::blocking_read(int target_fd, struct uss_address *received_address, struct uss_message *message)
+{
+	int final_ret = -1;
+#if(USS_FIFO == 1)	
+	ssize_t read_size = fifo_blocking_read(message, target_fd);
+	if(read_size != sizeof(struct uss_message)) dexit("blocking_read: read_size != so(mess)");
+	else final_ret = 0;
+	
+	*received_address = message->address;
+#elif(USS_RTSIG == 1)	
+	//do the read
+	struct signalfd_siginfo fdsi;
+	ssize_t read_size = rtsig_blocking_read(target_fd, &fdsi);
+	if(read_size != sizeof(struct signalfd_siginfo)) dexit("blocking_read: read_size != so(fdsi)");
+	else final_ret = 0;
+	
+	//fdsi.ssi_ptr => unwrap sigval into struct uss_message
+	convert_sigval_to_uss(fdsi.ssi_ptr, received_address, message);
+	//fdsi.ssi_pid => put into address
+	received_address->pid = fdsi.ssi_pid;
+#elif(USS_SHM == 1)
+	if(this->batch_read(target_fd, received_address, message, 1) == 1) {final_ret = 0;}
+#endif	
+	return final_ret;
+}
+
+/*(public)
+ * blocking receive of all available messages (at most max)
+ *
+ * return: number of messages received, -1 on error
+ */
+int uss_comm_controller::batch_read(int target_fd, struct uss_address *received_addresses, struct uss_message *messages, int max)
+{
+	int nof_messages = -1;
+#if(USS_FIFO == 1)	
+	ssize_t read_size = fifo_batch_read(messages, max, target_fd);
+	if(read_size <= 0 || read_size % sizeof(struct uss_message) != 0) dexit("batch_read: read_size is no multiple of so(mess)");
+	else nof_messages = read_size / sizeof(struct uss_message);
+	
+	for(int i = 0; i < nof_messages; i++) {received_addresses[i] = messages[i].address;}
+#elif(USS_RTSIG == 1)	
+	//do the read
+	struct signalfd_siginfo fdsi[USS_DISPATCHER_BATCH];
+	if(max > USS_DISPATCHER_BATCH) {max = USS_DISPATCHER_BATCH;}
+	ssize_t read_size = rtsig_batch_read(target_fd, fdsi, max);
+	if(read_size <= 0 || read_size % sizeof(struct signalfd_siginfo) != 0) dexit("batch_read: read_size is no multiple of so(fdsi)");
+	else nof_messages = read_size / sizeof(struct signalfd_siginfo);
+	
+	for(int i = 0; i < nof_messages; i++)
+	{
+		//fdsi.ssi_ptr => unwrap sigval into struct uss_message
+		convert_sigval_to_uss(fdsi[i].ssi_ptr, &received_addresses[i], &messages[i]);
+		//fdsi.ssi_pid => put into address
+		received_addresses[i].pid = fdsi[i].ssi_pid;
+	}
+#elif(USS_SHM == 1)
+	//sleep on doorbell until any client has pushed a message
+	struct uss_shm_doorbell *doorbell = &this->shm_daemon->to_daemon.doorbell;
+	uint32_t seq;
+	
+	nof_messages = shm_drain(messages, max);
+	while(nof_messages == 0)
+	{
+		seq = shm_prepare_wait(doorbell);
+		nof_messages = shm_drain(messages, max);
+		if(nof_messages > 0) {shm_cancel_wait(doorbell); break;}
+		
+		shm_wait(doorbell, seq);
+		nof_messages = shm_drain(messages, max);
+	}
+	
+	for(int i = 0; i < nof_messages; i++) {received_addresses[i] = messages[i].address;}
+#endif	
+	return nof_messages;
+}
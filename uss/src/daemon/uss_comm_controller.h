@@ -1,43 +1,96 @@
-#ifndef COMMUNICATION_CONTROLLER_H_INCLUDED
-#define COMMUNICATION_CONTROLLER_H_INCLUDED
-
-#include "./uss_daemon.h"
-
-using namespace std;
-
-//////////////////////////////////////////////
-//											//
-// class uss_communication_controller		//
-// interface declaration					//
-//											//
-//////////////////////////////////////////////
-#if(USS_FIFO == 1)
-typedef map<struct uss_address, int, less<struct uss_address> > uss_fifo_list;
-typedef uss_fifo_list::iterator uss_fifo_list_iterator;
-#endif
-
-class uss_comm_controller
-{
-	public:
-	uss_comm_controller();
-	~uss_comm_controller();
-
-#if(USS_FIFO == 1)
-	private:
-	pthread_mutex_t fifo_mutex;
-	uss_fifo_list fifo_list;	
-	public:
-	int get_fd_of_address(struct uss_address addr);
-	int delete_fd_of_address(struct uss_address addr);
-#endif
-	
-	int install_receiver(struct uss_address *addr);
-	int install_sender(struct uss_address *addr);
-	int uninstall_sender(struct uss_address *addr);
-	
-	int send(struct uss_address receiver_address, struct uss_message message);
-	
-	int blocking_read(int sfd, struct uss_address *received_address, struct uss_message *message);
-};
-
-#endif
+#ifndef COMMUNICATION_CONTROLLER_H_INCLUDED
+#define COMMUNICATION_CONTROLLER_H_INCLUDED
+
+#include "./uss_daemon.h"
+
+using namespace std;
+
+//////////////////////////////////////////////
+//											//
+// class uss_communication_controller		//
+// interface declaration					//
+//											//
+//////////////////////////////////////////////
+#if(USS_FIFO == 1 || USS_SHM == 1)
+typedef map<struct uss_address, int, less<struct uss_address> > uss_fifo_list;
+typedef uss_fifo_list::iterator uss_fifo_list_iterator;
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+typedef map<struct uss_address, struct uss_runon_slot*, less<struct uss_address> > uss_runon_list;
+typedef uss_runon_list::iterator uss_runon_list_iterator;
+#endif
+
+/*
+ * everything needed to send to one client
+ * -> resolved once (get_channel_of_address) when its job is added,
+ *    a send over it needs no lookup and no lock
+ * -> valid until uninstall_sender / uninstall_runon_slot of addr
+ */
+struct uss_channel
+{
+	struct uss_address addr;
+	int fd; //FIFO/SHM: sender
+#if(USS_SHM == 1)
+	struct uss_shm_region *region;
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+	struct uss_runon_slot *slot;
+#endif
+};
+
+class uss_comm_controller
+{
+	public:
+	uss_comm_controller();
+	~uss_comm_controller();
+
+#if(USS_FIFO == 1 || USS_SHM == 1)
+	private:
+	pthread_mutex_t fifo_mutex;
+	uss_fifo_list fifo_list;	
+	public:
+	int get_fd_of_address(struct uss_address addr);
+	int delete_fd_of_address(struct uss_address addr);
+#endif
+#if(USS_FIFO == 1)
+	private:
+	struct uss_address fifo_daemon_addr;
+	int fifo_daemon_receiver;
+	int fifo_daemon_sender; //passed to each library on registration
+	public:
+	int get_daemon_sender();
+#endif
+#if(USS_SHM == 1)
+	private:
+	struct uss_shm_region *shm_daemon; //doorbell of the daemon
+	vector<struct uss_shm_region*> shm_clients; //protected by fifo_mutex
+	unsigned int shm_next; //client to drain first
+	int shm_drain(struct uss_message *messages, int max);
+	public:
+#endif
+#if(USS_SHARED_RUN_ON == 1)
+	private:
+	pthread_mutex_t runon_mutex;
+	uss_runon_list runon_list;
+	struct uss_runon_slot* get_runon_slot_of_address(struct uss_address addr);
+	int add_runon_slot_of_address(struct uss_address addr, struct uss_runon_slot *slot);
+	struct uss_runon_slot* delete_runon_slot_of_address(struct uss_address addr);
+	public:
+#endif
+	
+	int install_receiver(struct uss_address *addr);
+	int install_sender(struct uss_address *addr, int channel);
+	int uninstall_sender(struct uss_address *addr);
+#if(USS_SHARED_RUN_ON == 1)
+	int install_runon_slot(struct uss_address *addr);
+	int uninstall_runon_slot(struct uss_address *addr);
+#endif
+	
+	int get_channel_of_address(struct uss_address addr, struct uss_channel *channel);
+	int send(struct uss_channel *channel, struct uss_message message);
+	
+	int blocking_read(int sfd, struct uss_address *received_address, struct uss_message *message);
+	int batch_read(int sfd, struct uss_address *received_addresses, struct uss_message *messages, int max);
+};
+
+#endif
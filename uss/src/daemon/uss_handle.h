@@ -0,0 +1,139 @@
+#ifndef HANDLE_H_INCLUDED
+#define HANDLE_H_INCLUDED
+
+#include "./uss_daemon.h"
+#include "../common/uss_tools.h"
+
+/*
+ * the handle allocator hands out the handles of the daemon
+ *
+ * a handle is (generation << USS_HANDLE_INDEX_BITS) | slot
+ * -> the slot indexes the se slab directly
+ * -> freeing a handle bumps the generation of its slot, so a late
+ *    message of a job that is gone carries a handle that no longer
+ *    matches its slot (dropped in O(1) instead of hitting a new owner)
+ * -> generation 0 is skipped => every handle is > 0
+ *
+ * free slots are kept on a lock-free stack (treiber stack)
+ * -> head packs a tag (high 32 bit) and the top slot (low 32 bit),
+ *    the tag is incremented by every push and pop (no ABA problem)
+ * -> slots that have never been used are taken by an atomic counter
+ *
+ * COMMENT:
+ * get() is called by the registration thread and put() by the daemon
+ * thread and the registration thread, neither of them takes a lock
+ */
+#define USS_HANDLE_NO_SLOT 0xffffffff
+
+class uss_handle_allocator
+{
+	private:
+	//generation of the current (or next) handle of each slot
+	uint32_t *generation;
+	//next free slot below each free slot on the stack
+	uint32_t *next_free;
+	//tag | top slot of the free stack
+	uint64_t free_head;
+	//slots below have been handed out at least once
+	uint32_t nof_slots;
+
+	int make_handle(uint32_t slot)
+	{
+		uint32_t g = __atomic_load_n(&generation[slot], __ATOMIC_ACQUIRE);
+		if(g == 0)
+		{
+			//first use of slot (only this thread owns it now)
+			g = 1;
+			__atomic_store_n(&generation[slot], g, __ATOMIC_RELEASE);
+		}
+		return (int)((g << USS_HANDLE_INDEX_BITS) | slot);
+	}
+
+	public:
+	uss_handle_allocator()
+	{
+		//(calloc of this size is mmapped => pages are touched on first use)
+		generation = (uint32_t*)calloc(USS_MAX_HANDLES, sizeof(uint32_t));
+		next_free = (uint32_t*)calloc(USS_MAX_HANDLES, sizeof(uint32_t));
+		if(generation == NULL || next_free == NULL) {dexit("uss_handle_allocator: calloc");}
+		free_head = USS_HANDLE_NO_SLOT;
+		nof_slots = 0;
+	}
+
+	~uss_handle_allocator()
+	{
+		free(generation);
+		free(next_free);
+	}
+
+	static int slot_of(int handle)
+	{
+		return handle & USS_HANDLE_INDEX_MASK;
+	}
+
+	/*
+	 * returns a fresh handle or -1 if all USS_MAX_HANDLES are in use
+	 */
+	int get()
+	{
+		uint64_t head = __atomic_load_n(&free_head, __ATOMIC_ACQUIRE);
+		while((uint32_t)head != USS_HANDLE_NO_SLOT)
+		{
+			uint32_t slot = (uint32_t)head;
+			//(may be stale if slot was popped meanwhile, then the tag differs)
+			uint32_t next = __atomic_load_n(&next_free[slot], __ATOMIC_RELAXED);
+			uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+			if(__atomic_compare_exchange_n(&free_head, &head, new_head, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			{
+				return make_handle(slot);
+			}
+		}
+
+		//free stack empty => take a slot never used before
+		uint32_t slot = __atomic_fetch_add(&nof_slots, 1, __ATOMIC_RELAXED);
+		if(slot >= USS_MAX_HANDLES)
+		{
+			__atomic_fetch_sub(&nof_slots, 1, __ATOMIC_RELAXED);
+			return -1;
+		}
+		return make_handle(slot);
+	}
+
+	/*
+	 * frees handle, its slot is reused with the next generation
+	 * returns -1 if handle is stale (already freed)
+	 */
+	int put(int handle)
+	{
+		if(handle <= 0) {return -1;}
+		uint32_t slot = slot_of(handle);
+		uint32_t g = (uint32_t)handle >> USS_HANDLE_INDEX_BITS;
+		uint32_t next_g = (g + 1) & USS_HANDLE_GENERATION_MASK;
+		if(next_g == 0) {next_g = 1;}
+		//only the owner of the current generation gets through
+		if(!__atomic_compare_exchange_n(&generation[slot], &g, next_g, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {return -1;}
+
+		uint64_t head = __atomic_load_n(&free_head, __ATOMIC_ACQUIRE);
+		uint64_t new_head;
+		do
+		{
+			__atomic_store_n(&next_free[slot], (uint32_t)head, __ATOMIC_RELAXED);
+			new_head = (((head >> 32) + 1) << 32) | slot;
+		}
+		while(!__atomic_compare_exchange_n(&free_head, &head, new_head, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+		return 0;
+	}
+
+	/*
+	 * returns 1 if handle is the handle currently given out for its slot
+	 * (a freed handle is never current again until its generation wraps)
+	 */
+	int is_current(int handle)
+	{
+		if(handle <= 0) {return 0;}
+		uint32_t g = __atomic_load_n(&generation[slot_of(handle)], __ATOMIC_ACQUIRE);
+		return (g == ((uint32_t)handle >> USS_HANDLE_INDEX_BITS));
+	}
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef PLACEMENT_H_INCLUDED
+#define PLACEMENT_H_INCLUDED
+
+#include <stdint.h>
+
+/*
+ * affinity a job has on an accelerator it works best on
+ * (see meta_sched_info in uss.h)
+ */
+#define USS_PLACEMENT_AFFINITY_MAX 10
+
+/*
+ * speed of a device that runs a job in the measured service time
+ * (a device of speed 200 needs half of it, see USS_DEVICE_SPEED_*)
+ */
+#define USS_PLACEMENT_SPEED_REFERENCE 100
+
+/*
+ * expected time [ns] until a new job is finished if it is put into a rq
+ *
+ * service_ns: service time of a job of affinity 10 on the type of rq
+ * affinity: of the new job on the type of rq
+ * rq_length: jobs already in rq (they share the device with it)
+ * switch_cost: of the type of rq (init and free once at least)
+ *
+ * -> the job alone needs own = service_ns * 10 / affinity
+ * -> rq is shared fair (vruntime): until the job is done every other
+ *    job of rq gets the same time, but no more than it needs itself
+ *    (which is assumed to be service_ns)
+ *
+ * returns ~0 if the job can not run there (affinity 0)
+ */
+static inline uint64_t uss_expected_completion(uint64_t service_ns, int affinity, int rq_length, uint64_t switch_cost)
+{
+	if(affinity <= 0) {return ~(uint64_t)0;}
+	uint64_t own = (service_ns * USS_PLACEMENT_AFFINITY_MAX) / (uint64_t)affinity;
+	uint64_t other = (own < service_ns) ? own : service_ns;
+	return own + (uint64_t)rq_length * other + switch_cost;
+}
+
+/*
+ * time [ns] a device of speed needs for what takes ns on the reference
+ */
+static inline uint64_t uss_device_time(uint64_t ns, int speed)
+{
+	if(speed <= 0) {return ns;}
+	return (ns * USS_PLACEMENT_SPEED_REFERENCE) / (uint64_t)speed;
+}
+
+/*
+ * load of a rq by capacity: rq_length jobs share a device of speed
+ * (the rq with the least load per capacity gets the next job)
+ */
+static inline double uss_capacity_load(int rq_length, int speed)
+{
+	if(speed <= 0) {speed = USS_PLACEMENT_SPEED_REFERENCE;}
+	return ((double)rq_length * USS_PLACEMENT_SPEED_REFERENCE) / (double)speed;
+}
+
+#endif
@@ -0,0 +1,344 @@
+#include "./uss_rbtree.h"
+
+//////////////////////////////////////////////
+//											//
+// intrusive red-black tree					//
+//											//
+//////////////////////////////////////////////
+/***************************************\
+* helpers								*
+\***************************************/
+static inline int is_red(struct uss_rb_node *n)
+{
+	return (n != NULL && n->color == USS_RB_RED);
+}
+
+/*
+ * put new in place of old below old's parent
+ */
+static inline void replace_child(struct uss_rb_node *old, struct uss_rb_node *nw,
+								 struct uss_rb_node *parent, struct uss_rb_root *root)
+{
+	if(parent == NULL) {root->node = nw;}
+	else if(parent->left == old) {parent->left = nw;}
+	else {parent->right = nw;}
+}
+
+static void rotate_left(struct uss_rb_node *x, struct uss_rb_root *root)
+{
+	struct uss_rb_node *y = x->right;
+
+	x->right = y->left;
+	if(y->left != NULL) {y->left->parent = x;}
+
+	y->parent = x->parent;
+	replace_child(x, y, x->parent, root);
+
+	y->left = x;
+	x->parent = y;
+}
+
+static void rotate_right(struct uss_rb_node *x, struct uss_rb_root *root)
+{
+	struct uss_rb_node *y = x->left;
+
+	x->left = y->right;
+	if(y->right != NULL) {y->right->parent = x;}
+
+	y->parent = x->parent;
+	replace_child(x, y, x->parent, root);
+
+	y->right = x;
+	x->parent = y;
+}
+
+/***************************************\
+* insert								*
+\***************************************/
+void uss_rb_link_node(struct uss_rb_node *node, struct uss_rb_node *parent, struct uss_rb_node **link)
+{
+	node->parent = parent;
+	node->left = NULL;
+	node->right = NULL;
+	node->color = USS_RB_RED;
+	*link = node;
+}
+
+void uss_rb_insert_color(struct uss_rb_node *node, struct uss_rb_root *root, int is_leftmost)
+{
+	struct uss_rb_node *parent, *gparent, *uncle;
+
+	if(is_leftmost) {root->leftmost = node;}
+
+	while((parent = node->parent) != NULL && parent->color == USS_RB_RED)
+	{
+		//a red parent is never the root => gparent exists
+		gparent = parent->parent;
+		if(parent == gparent->left)
+		{
+			uncle = gparent->right;
+			if(is_red(uncle))
+			{
+				parent->color = USS_RB_BLACK;
+				uncle->color = USS_RB_BLACK;
+				gparent->color = USS_RB_RED;
+				node = gparent;
+				continue;
+			}
+			if(node == parent->right)
+			{
+				rotate_left(parent, root);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->color = USS_RB_BLACK;
+			gparent->color = USS_RB_RED;
+			rotate_right(gparent, root);
+		}
+		else
+		{
+			uncle = gparent->left;
+			if(is_red(uncle))
+			{
+				parent->color = USS_RB_BLACK;
+				uncle->color = USS_RB_BLACK;
+				gparent->color = USS_RB_RED;
+				node = gparent;
+				continue;
+			}
+			if(node == parent->left)
+			{
+				rotate_right(parent, root);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->color = USS_RB_BLACK;
+			gparent->color = USS_RB_RED;
+			rotate_left(gparent, root);
+		}
+	}
+	root->node->color = USS_RB_BLACK;
+}
+
+/***************************************\
+* erase									*
+\***************************************/
+/*
+ * restore the black height after a black node has been removed
+ * (node may be NULL so its parent is given separately)
+ */
+static void erase_color(struct uss_rb_node *node, struct uss_rb_node *parent, struct uss_rb_root *root)
+{
+	struct uss_rb_node *sibling;
+
+	while(node != root->node && !is_red(node))
+	{
+		if(node == parent->left)
+		{
+			sibling = parent->right;
+			if(is_red(sibling))
+			{
+				sibling->color = USS_RB_BLACK;
+				parent->color = USS_RB_RED;
+				rotate_left(parent, root);
+				sibling = parent->right;
+			}
+			if(!is_red(sibling->left) && !is_red(sibling->right))
+			{
+				sibling->color = USS_RB_RED;
+				node = parent;
+				parent = node->parent;
+			}
+			else
+			{
+				if(!is_red(sibling->right))
+				{
+					sibling->left->color = USS_RB_BLACK;
+					sibling->color = USS_RB_RED;
+					rotate_right(sibling, root);
+					sibling = parent->right;
+				}
+				sibling->color = parent->color;
+				parent->color = USS_RB_BLACK;
+				sibling->right->color = USS_RB_BLACK;
+				rotate_left(parent, root);
+				node = root->node;
+				break;
+			}
+		}
+		else
+		{
+			sibling = parent->left;
+			if(is_red(sibling))
+			{
+				sibling->color = USS_RB_BLACK;
+				parent->color = USS_RB_RED;
+				rotate_right(parent, root);
+				sibling = parent->left;
+			}
+			if(!is_red(sibling->left) && !is_red(sibling->right))
+			{
+				sibling->color = USS_RB_RED;
+				node = parent;
+				parent = node->parent;
+			}
+			else
+			{
+				if(!is_red(sibling->left))
+				{
+					sibling->right->color = USS_RB_BLACK;
+					sibling->color = USS_RB_RED;
+					rotate_left(sibling, root);
+					sibling = parent->left;
+				}
+				sibling->color = parent->color;
+				parent->color = USS_RB_BLACK;
+				sibling->left->color = USS_RB_BLACK;
+				rotate_right(parent, root);
+				node = root->node;
+				break;
+			}
+		}
+	}
+	if(node != NULL) {node->color = USS_RB_BLACK;}
+}
+
+void uss_rb_erase(struct uss_rb_node *node, struct uss_rb_root *root)
+{
+	struct uss_rb_node *child, *parent;
+	int color;
+
+	if(root->leftmost == node) {root->leftmost = uss_rb_next(node);}
+
+	if(node->left == NULL || node->right == NULL)
+	{
+		//at most one child => replace node by it
+		child = (node->left != NULL) ? node->left : node->right;
+		parent = node->parent;
+		color = node->color;
+
+		if(child != NULL) {child->parent = parent;}
+		replace_child(node, child, parent, root);
+	}
+	else
+	{
+		//two children => replace node by its successor (which has no left child)
+		struct uss_rb_node *successor = node->right;
+		while(successor->left != NULL) {successor = successor->left;}
+
+		child = successor->right;
+		color = successor->color;
+
+		if(successor->parent == node)
+		{
+			parent = successor;
+		}
+		else
+		{
+			parent = successor->parent;
+			parent->left = child;
+			if(child != NULL) {child->parent = parent;}
+
+			successor->right = node->right;
+			node->right->parent = successor;
+		}
+
+		successor->left = node->left;
+		node->left->parent = successor;
+		successor->parent = node->parent;
+		successor->color = node->color;
+		replace_child(node, successor, node->parent, root);
+	}
+
+	if(color == USS_RB_BLACK) {erase_color(child, parent, root);}
+}
+
+/***************************************\
+* iterate								*
+\***************************************/
+struct uss_rb_node* uss_rb_next(struct uss_rb_node *node)
+{
+	if(node->right != NULL)
+	{
+		node = node->right;
+		while(node->left != NULL) {node = node->left;}
+		return node;
+	}
+
+	while(node->parent != NULL && node == node->parent->right) {node = node->parent;}
+	return node->parent;
+}
+
+
+//////////////////////////////////////////////
+//											//
+// rq tree									//
+//											//
+//////////////////////////////////////////////
+uss_rq_tree::uss_rq_tree()
+{
+	root.node = NULL;
+	root.leftmost = NULL;
+	nof_nodes = 0;
+}
+
+/*
+ * n->vruntime and n->handle have to be set before
+ */
+void uss_rq_tree::insert(struct uss_rq_node *n)
+{
+	struct uss_rb_node **link = &root.node;
+	struct uss_rb_node *parent = NULL;
+	int is_leftmost = 1;
+
+	while(*link != NULL)
+	{
+		parent = *link;
+		if(*n < *(struct uss_rq_node*)parent)
+		{
+			link = &parent->left;
+		}
+		else
+		{
+			link = &parent->right;
+			is_leftmost = 0;
+		}
+	}
+
+	uss_rb_link_node(&n->rb, parent, link);
+	uss_rb_insert_color(&n->rb, &root, is_leftmost);
+	nof_nodes++;
+}
+
+void uss_rq_tree::erase(struct uss_rq_node *n)
+{
+	uss_rb_erase(&n->rb, &root);
+	nof_nodes--;
+}
+
+/*
+ * requeue n with a new vruntime
+ *
+ * COMMENT:
+ * the vruntime of a running se only grows, so mostly it is still
+ * smaller than its successor => change key in place without rebalancing
+ */
+void uss_rq_tree::update(struct uss_rq_node *n, uss_nanotime vruntime)
+{
+	struct uss_rq_node probe = *n;
+	probe.vruntime = vruntime;
+
+	if(n->vruntime < vruntime || n->vruntime == vruntime)
+	{
+		struct uss_rq_node *next_of_n = next(n);
+		if(next_of_n == NULL || probe < *next_of_n)
+		{
+			n->vruntime = vruntime;
+			return;
+		}
+	}
+
+	erase(n);
+	n->vruntime = vruntime;
+	insert(n);
+}
@@ -0,0 +1,97 @@
+#ifndef RBTREE_H_INCLUDED
+#define RBTREE_H_INCLUDED
+
+#include "./uss_daemon.h"
+
+/***************************************\
+* intrusive red-black tree				*
+\***************************************/
+/*
+ * the node is embedded into the element that is stored in a tree
+ * -> enqueue and dequeue never allocate memory
+ * -> the root caches the leftmost node => first element in O(1)
+ *
+ * the tree only does the balancing, the caller walks down to the
+ * insertion point itself (it knows how to compare its elements)
+ *
+ * COMMENT:
+ * the tree does no locking
+ */
+#define USS_RB_RED 0
+#define USS_RB_BLACK 1
+
+struct uss_rb_node
+{
+	struct uss_rb_node *parent;
+	struct uss_rb_node *left;
+	struct uss_rb_node *right;
+	int color;
+};
+
+struct uss_rb_root
+{
+	struct uss_rb_node *node;
+	struct uss_rb_node *leftmost;
+};
+
+//link node as child of parent (link is &parent->left or &parent->right or &root->node)
+void uss_rb_link_node(struct uss_rb_node *node, struct uss_rb_node *parent, struct uss_rb_node **link);
+//rebalance after linking (is_leftmost: node was linked by only going left)
+void uss_rb_insert_color(struct uss_rb_node *node, struct uss_rb_root *root, int is_leftmost);
+void uss_rb_erase(struct uss_rb_node *node, struct uss_rb_root *root);
+struct uss_rb_node* uss_rb_next(struct uss_rb_node *node);
+
+
+/***************************************\
+* rq tree								*
+\***************************************/
+/*
+ * node of a rq tree ordered by (vruntime, handle)
+ * -> embedded in the se of handle
+ * -> in the deadline tree of a rq vruntime holds the deadline
+ */
+struct uss_rq_node
+{
+	struct uss_rb_node rb; //must be first
+	uss_nanotime vruntime;
+	int handle;
+
+	bool operator< (const struct uss_rq_node& other) const
+	{
+		return (this->vruntime < other.vruntime || (this->vruntime == other.vruntime && this->handle < other.handle));
+	}
+};
+
+/*
+ * this holds the ses of a rq ordered by vruntime
+ */
+class uss_rq_tree
+{
+	private:
+	struct uss_rb_root root;
+	int nof_nodes;
+
+	public:
+	uss_rq_tree();
+
+	void insert(struct uss_rq_node *n);
+	void erase(struct uss_rq_node *n);
+	void update(struct uss_rq_node *n, uss_nanotime vruntime);
+
+	struct uss_rq_node* first()
+	{
+		return (struct uss_rq_node*) root.leftmost;
+	}
+
+	static struct uss_rq_node* next(struct uss_rq_node *n)
+	{
+		return (struct uss_rq_node*) uss_rb_next(&n->rb);
+	}
+
+	int size()
+	{
+		return nof_nodes;
+	}
+};
+
+#endif
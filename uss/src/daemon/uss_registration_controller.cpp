@@ -1,705 +1,826 @@
-#include "./uss_daemon.h"
-#include "../common/uss_tools.h"
-#include "./uss_registration_controller.h"
-#include "./uss_scheduler.h"
-
-using namespace std;
-
-//////////////////////////////////////////////
-//											//
-// class uss_registration_controller		//
-// interface definitions					//
-//											//
-//////////////////////////////////////////////
-
-/***************************************\
-* constructor and destructor			*
-\***************************************/
-uss_registration_controller::uss_registration_controller(class uss_comm_controller *cc)
-{
-	max_handle = 0;
-	new_regs = 0;
-	
-	//creator thread should be main thread here
-	creator_thread = pthread_self();
-	
-	//save link to communication controller (to setup connections during registration procedure)
-	this->cc = cc;
-	
-	//prepare mutex and cond
-	if(pthread_mutex_init(&reg_mutex, NULL) != 0) {printf("error with mutex init\n"); exit(-1);}
-	if(pthread_mutex_init(&handle_mutex, NULL) != 0) {printf("error with mutex init\n"); exit(-1);}
-	if(pthread_cond_init(&reg_cond, NULL) != 0) {printf("error with cond init\n"); exit(-1);}
-}
-
-
-uss_registration_controller::~uss_registration_controller()
-{
-	printf("reg_table destroyed\n");
-	pthread_cond_destroy(&reg_cond);
-	pthread_mutex_destroy(&handle_mutex);
-	pthread_mutex_destroy(&reg_mutex);
-}
-
-
-/***************************************\
-* reg_*_table add and remove			*
-\***************************************/
-/*
- * a reg_pending_entry should be removed if the scheduler has made
- * its decision
- */
-int uss_registration_controller::remove_reg_pending_entry(int h)
-{
-	int ret;
-	ret = pthread_mutex_lock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	//remove
-	pthread_mutex_destroy(&reg_pending_table[h].mtx_status);
-	pthread_cond_destroy(&reg_pending_table[h].cond_status);
-	reg_pending_table.erase(h);
-	
-	ret = pthread_mutex_unlock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	return 0;
-}
-
-
-/*
- * upon each new registration attempt an entry will be in this table
- * until the scheduler has either accepted or declined it
- */
-int uss_registration_controller::add_reg_pending_entry(struct meta_sched_addr_info *msai)
-{
-	//
-	//get a fresh handle for this request
-	//
-	int handle = this->get_unique_handle();
-	if(handle < 0) {printf("(derror) problem when getting a handle"); return -1;}
-	int ret;
-	
-	//
-	//prepare uss_reg_entry
-	//
-	struct uss_reg_pending_entry entry;
-	entry.handle = handle;
-	entry.msai = (*msai);
-	entry.status = USS_CONTROL_NOT_PROCESSED;
-	
-	//
-	//insert and inizialize into registration table
-	//
-	ret = pthread_mutex_lock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	//insert
-	reg_pending_table.insert(make_pair(handle, entry));
-	//initialize mutex and condition variable
-	pthread_mutex_init(&(reg_pending_table[handle].mtx_status), NULL);
-	pthread_cond_init(&(reg_pending_table[handle].cond_status), NULL);
-	
-	ret = pthread_mutex_unlock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	return handle;
-}
-
-/*
- * this is called by schedulers cleanup/is_finished method
- * COMMENT: also removes from the address from addr_table
- */
-int uss_registration_controller::remove_reg_addr_entry(int h)
-{
-	int ret;
-	
-	struct uss_address a = get_address_of_handle(h);
-	
-	/*protect addr_table (because we do a find on it in some other thread)*/
-	ret = pthread_mutex_lock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	addr_table.erase(a);
-	reg_table.erase(h);
-	
-	ret = pthread_mutex_unlock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	return 0;
-}
-
-
-/*
- * this is only called when the scheduler accepted an reg_pending_entry
- */
-int uss_registration_controller::add_reg_addr_entry(int handle, struct uss_address *addr)
-{
-	int ret;
-	ret = pthread_mutex_lock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	//insert
-	reg_table.insert(make_pair(handle, (*addr)));
-	addr_table.insert(make_pair((*addr), handle));
-	
-	ret = pthread_mutex_unlock(&reg_mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	return 0;
-}
-
-
-/*
- * print an entry selected by handle h
- */
-int uss_registration_controller::print_entry(int h)
-{
-	//printf("print test: %i %i \n", reg_table[h].msi_short.length, reg_table[h].msi_short.pid);	
-	return 0;
-}
-
-
-/***************************************\
-* registration helpers					*
-\***************************************/
-/*
- * return -1 on error
- */
-int uss_registration_controller::get_nof_new_regs()
-{
-	return this->new_regs;
-}
-
-
-/*
- * returns or exits programm
- */
-void uss_registration_controller::increase_new_regs(void)
-{
-	int ret;
-	ret = pthread_mutex_lock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-	
-	this->new_regs += 1;
-	
-	ret = pthread_mutex_unlock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}	
-	return;
-}
-
-
-/*
- * returns or exits programm
- */
-void uss_registration_controller::decrease_new_regs(void)
-{
-	int ret;
-	ret = pthread_mutex_lock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-	
-	this->new_regs -= 1;
-	
-	ret = pthread_mutex_unlock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}	
-	return;
-}
-
-/*
- * return a handle or -1 on error
- */
-int uss_registration_controller::get_new_reg(void)
-{
-	int ret;
-	int final_ret = -1;
-	type_reg_pending_table_iterator selected_reg_pending_table_entry;
-	ret = pthread_mutex_lock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-	
-	/*
-	 *select only pending table entries with status USS_CONTROL_NOT_PROCESSED
-	 *because other have already been process by scheduler(main thread) but not
-	 *ultimately finalized by dispatcher(registration thread)
-	 *COMMENT:
-	 *no further mutex is required: this is the main thread so 
-	 *status USS_CONTROL_* cannot change in the meantime
-	 */
-	selected_reg_pending_table_entry = this->reg_pending_table.begin();
-	for(; selected_reg_pending_table_entry != this->reg_pending_table.end(); selected_reg_pending_table_entry++)
-	{
-		if((*selected_reg_pending_table_entry).second.status == USS_CONTROL_NOT_PROCESSED)
-		{
-			final_ret = (*selected_reg_pending_table_entry).second.handle;
-		}
-	}	
-	
-	ret = pthread_mutex_unlock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}	
-	
-	return final_ret;
-}
-
-
-/*
- * puts sched resp into reg_pending_table and signals the corresponding thread
- */
-void uss_registration_controller::finish_registration(int handle, int accepted)
-{
-	int ret;
-	ret = pthread_mutex_lock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-	ret = pthread_mutex_lock(&(this->reg_pending_table[handle].mtx_status));
-	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}	
-	
-	if(accepted == USS_CONTROL_SCHED_ACCEPTED)
-	{
-		//sched accepted this new reg identified by handle
-		this->reg_pending_table[handle].status = USS_CONTROL_SCHED_ACCEPTED;
-	}
-	else if(accepted == USS_CONTROL_SCHED_DECLINED)
-	{
-		//sched rejected this new reg
-		this->reg_pending_table[handle].status = USS_CONTROL_SCHED_DECLINED;
-	}
-	else
-	{
-		//sth odd happend
-		dexit("process_sched_response did sth odd");
-	}
-	
-	ret = pthread_mutex_unlock(&(this->reg_pending_table[handle].mtx_status));
-	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}
-	
-	//signal the waiting registration dispatcher thread
-	ret = pthread_cond_signal(&(this->reg_pending_table[handle].cond_status));
-	if(ret != 0) {derr("problem with pthread_cond_signal"); exit(-1);}	
-	
-	ret = pthread_mutex_unlock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}
-	
-	//finished processing a new registration -> decrease nof_new_regs
-	this->decrease_new_regs();
-}
-
-
-/***************************************\
-* handle GET something					*
-\***************************************/
-int uss_registration_controller::get_handle_of_address(struct uss_address searched_address)
-{
-	int ret, final_ret = -1;
-	ret = pthread_mutex_lock(&this->reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	type_addr_table_iterator it = addr_table.find(searched_address);
-	if(it != addr_table.end())
-	{
-		final_ret = (*it).second;
-	}
-	else
-	{
-		dexit("get_handle_of_addres ADDR not found");
-	}
-	
-	ret = pthread_mutex_unlock(&this->reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	return final_ret;
-}
-
-struct uss_address uss_registration_controller::get_address_of_handle(int han)
-{
-	int ret, final_ret = -1;
-	ret = pthread_mutex_lock(&this->reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	type_reg_table_iterator it = reg_table.find(han);
-	
-	ret = pthread_mutex_unlock(&this->reg_mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	if(it != reg_table.end())
-	{
-		//found handle in table
-		return (*it).second;
-	}
-	else
-	{
-		//error or not found
-		dexit("get_address_of_handle HANDLE not found");
-		struct uss_address error_struct;
-		memset(&error_struct, 0, sizeof(struct uss_address));
-		return error_struct;
-	}
-}
-
-
-/*
- * this will create a unique handle
- * -> later it should recycle old handles that are not used any more
- *    but no we will just increment the number
- */
-int uss_registration_controller::get_unique_handle()
-{
-	//a handle will be unique in all of USS daemon
-	/*
-	 *in a young daemon will start counting up from 1
-	 *
-	 *if the daemon finished all work related to a handle, it is
-	 *discarded into the 'reuse_handles' list and old handles can be
-	 *recycled
-	 *
-	 *therefore this method first tries to recycle an old handle by looking into
-	 *the reused_handles list
-	 *
-	 *if nothing is there, then a completely new handles it created until the maximum
-	 *of 2 million is reached 
-	 *(WARNING: this is considered an overflow and the daemon will exit)
-	 *
-	 *COMMENT:
-	 *mutex protection because the main thread will enter on this list
-	 *and iterator may change
-	 */
-	int ret, final_ret = -1;
-	
-	ret = pthread_mutex_lock(&(this->handle_mutex));
-	if(ret != 0) {dexit("problem with pthread_mutex_lock");}
-	
-	set<int>::iterator iter = this->reuse_handles.begin();
-	if(iter != this->reuse_handles.end())
-	{
-		int h = (*iter);
-		
-		//pop from recycling list
-		reuse_handles.erase(h);
-		
-		//return new fetched value as new_handle
-		final_ret = h;
-	}
-	else
-	{
-		 final_ret = ++max_handle;
-	}
-	
-	ret = pthread_mutex_unlock(&(this->handle_mutex));
-	if(ret != 0) {dexit("problem with pthread_mutex_unlock");}
-	
-	return final_ret;
-}
-
-
-struct meta_sched_addr_info uss_registration_controller::get_msai(int handle)
-{
-	int ret;
-	type_reg_pending_table_iterator iter;
-	ret = pthread_mutex_lock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-	
-	iter = this->reg_pending_table.find(handle);
-	
-	ret = pthread_mutex_unlock(&(this->reg_mutex));
-	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}
-	
-	if(iter != this->reg_pending_table.end())
-	{
-		//success
-		return (*iter).second.msai;
-	}
-	else
-	{
-		//search must not fail, since searching for a specific previously added entry
-		dexit("get_msi failed");
-		struct meta_sched_addr_info fail_msai;
-		return fail_msai; 
-	}
-}
-
-
-////////////////////////////////////////
-//
-//thread for registration
-//using interface class uss_registration_controller
-//
-////////////////////////////////////////
-
-/*
- * small helper for registration thread
- */
-struct thread_helper
-{
-	uss_registration_controller *reg_controller;
-	int *file_descriptor;
-	pthread_mutex_t *mutex;
-	pthread_cond_t *cond;
-	int parameter_transported;
-};
-
-/*
- * handle_incomming_registrations()
- *
- * (created as a thread)
- *
- * explicitly does operations for each new
- * registrations
- */
-void* handle_incoming_registration(void *ptr)
-{
-	#if(USS_DAEMON_DEBUG == 1)
-	printf("[reg disp t] new incoming registration will be handled\n");
-	#endif
-	//detach so this needn't be joined anyhow
-	pthread_detach(pthread_self());
-	
-	//read parameter which is struct thread_helper
-	struct thread_helper *th = (struct thread_helper*) ptr;
-	int ret, status;
-	uss_registration_controller *rc = th->reg_controller;
-	int *int_ptr = th->file_descriptor;
-	int current_sfd = *int_ptr;
-	
-	ret = pthread_mutex_lock(th->mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	th->parameter_transported = 1;
-	
-	ret = pthread_mutex_unlock(th->mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	ret = pthread_cond_signal(th->cond);
-	if(ret != 0) dexit("thread_cond_signal");
-	
-	//read msai from client over socket
-	struct meta_sched_addr_info transport;
-	memset(&transport, 0, sizeof(struct meta_sched_addr_info));
-	int nof_br = read(current_sfd, &transport, sizeof(struct meta_sched_addr_info));
-	
-	//if we received too small msai return error value
-	if(nof_br != sizeof(struct meta_sched_addr_info))
-	{
-		dexit("received too small msai");
-	}
-	
-	//if this address is already present in daemon reject this request
-	struct uss_registration_response resp;
-	memset(&resp, 0, sizeof(struct uss_registration_response));
-	
-	int addr_already_exists = 0;
-	ret = pthread_mutex_lock(&rc->reg_mutex);
-	if(ret != 0) dexit("thread_mutex_lock");
-	
-	/*search with O(log(n)) and check if it has already been present*/
-	type_addr_table_iterator it = rc->addr_table.find(transport.addr);
-	if(it != rc->addr_table.end()) {addr_already_exists = 1;}
-	
-	ret = pthread_mutex_unlock(&rc->reg_mutex);
-	if(ret != 0) dexit("thread_mutex_unlock");
-	
-	if(addr_already_exists)
-	{
-		resp.check = USS_CONTROL_SCHED_DECLINED;
-		//printf("addr=%lld\n",transport.addr.fifo);
-		write(current_sfd, &resp, sizeof(struct uss_registration_response));
-		dexit("WARNING: got incoming registration from same address\n");
-	}
-	else
-	{
-		//REGISTRATION
-		//setup the sending facility (opening a fifo created by library)
-		rc->cc->install_sender(&transport.addr);
-		
-		//enter msi_short into registered_table (entrys state will be USS_CONTROL_NOT_PROCESSED)
-		int new_handle = rc->add_reg_pending_entry(&transport);
-						 rc->add_reg_addr_entry(new_handle, &transport.addr);
-		if(new_handle == -1) {dexit("could not add reg_entry");}
-	
-		#if(USS_DAEMON_DEBUG == 1)
-		printf("[reg disp t] add_reg_pending_entry with handle = %i\n", new_handle);
-		#endif
-		//increase number of jobs awaiting sched approval(producer)
-		rc->increase_new_regs();
-		
-		//signal to main to handle a new registration
-		//ret = pthread_kill(rc->creator_thread, SIGUSR1);
-		//if(ret != 0) {derr("could not notify main_thread of new registration"); exit(-1);}
-
-		//wait on condition variable of added line in reg_pending_table
-		ret = pthread_mutex_lock(&(rc->reg_pending_table[new_handle].mtx_status));
-		if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-		
-		while(rc->reg_pending_table[new_handle].status == USS_CONTROL_NOT_PROCESSED)
-		{
-			ret = pthread_cond_wait(&(rc->reg_pending_table[new_handle].cond_status), 
-									&(rc->reg_pending_table[new_handle].mtx_status));
-			if(ret != 0) {derr("problem with pthread_cond_wait"); exit(-1);}
-		}
-		status = rc->reg_pending_table[new_handle].status;
-		
-		ret = pthread_mutex_unlock(&(rc->reg_pending_table[new_handle].mtx_status));
-		if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
-		
-		//wait finished -> status is go/nogo from scheduler
-		if(status == USS_CONTROL_SCHED_ACCEPTED) 
-		{
-			//scheduler accecpted this reg
-			//=> write correct size back
-			resp.check = USS_CONTROL_SCHED_ACCEPTED;
-		}
-		else if(status == USS_CONTROL_SCHED_DECLINED)
-		{
-			//scheduler declined this reg
-			//=> write error back
-			resp.check = USS_CONTROL_SCHED_DECLINED;
-		}
-		else
-		{
-			//sth odd happend
-			dexit("wrong scheduler response?");
-		}
-	
-		//write registration response back
-		resp.daemon_addr.pid = getpid();
-		#if(USS_FIFO == 1)
-		resp.daemon_addr.fifo = 1;
-		#elif(USS_RTSIG == 1)
-		resp.daemon_addr.lid = 0;
-		#endif
-		resp.client_addr = transport.addr;
-		
-		write(current_sfd, &resp, sizeof(struct uss_registration_response));
-		
-		if(status == USS_CONTROL_SCHED_ACCEPTED) 
-		{
-			//move from pending to reg
-			rc->remove_reg_pending_entry(new_handle);
-		}
-		else
-		{
-			//just remove
-			rc->remove_reg_pending_entry(new_handle);
-			rc->remove_reg_addr_entry(new_handle);
-			
-			//thread safe mark this handle as 'done'
-			ret = pthread_mutex_lock(&(rc->handle_mutex));
-			if(ret != 0) {dexit("problem with pthread_mutex_lock");}
-			
-			rc->reuse_handles.insert(new_handle);
-			
-			ret = pthread_mutex_unlock(&(rc->handle_mutex));
-			if(ret != 0) {dexit("problem with pthread_mutex_unlock");}			
-		}
-		#if(USS_DAEMON_DEBUG == 1)
-		printf("[reg disp t] finished dispatching a registration attempt\n");
-		#endif
-	}
-	
-	//signal that more new reg threads can be spawned
-	ret = pthread_cond_signal(&(rc->reg_cond));
-	if(ret != 0) {derr("problem with pthread_cond_signal"); exit(-1);}		
-
-	ret = close(current_sfd);
-	if(ret==-1) {printf("dderror: closing server socket failed\n\n"); exit(1);}
-	return NULL;
-}
-
-
-/*
- * start_handle_incomming_registrations()
- *
- * (created as a thread)
- *
- * this will in turn start a new thread for each incoming
- * registration (for each socket connection)
- */
-void* start_handle_incoming_registrations(void *ptr)
-{
-	//printf("\n[reg thread] started to handle incoming registrations\n");
-	//detach so this needn't be joined anyhow
-	pthread_detach(pthread_self());
-	
-	//
-	//void pointer *ptr is address to registration_controller
-	//
-	uss_registration_controller *rc = (uss_registration_controller*) ptr;
-	
-	int sfd, ret;
-	struct sockaddr_un server_addr;
-	//
-	//create a socket
-	//
-	ret = remove(USS_REGISTRATION_DAEMON_SOCKET);
-	if(ret == -1 && errno != ENOENT) {dexit("problem when trying to remove old socket");}
-	
-	sfd = socket(AF_UNIX, SOCK_STREAM, 0);
-	if(sfd==-1) {printf("dderror: creating socket\n"); return NULL;}
-	
-	memset(&server_addr, 0, sizeof(struct sockaddr_un));
-	server_addr.sun_family = AF_UNIX;
-	strncpy(server_addr.sun_path, USS_REGISTRATION_DAEMON_SOCKET, sizeof(server_addr.sun_path)-1);
-	
-	ret = bind(sfd, (struct sockaddr*) &server_addr, sizeof(struct sockaddr_un));
-	if(sfd==-1) {printf("dderror: binding socket failed\n"); return NULL;}
-	
-	ret = listen(sfd, 1028);
-	if(sfd==-1) {printf("dderror: listen on socket failed\n"); return NULL;}
-	#if(USS_DAEMON_DEBUG == 1)
-	printf("[reg thread]   server listening\n");
-	#endif
-	
-	//prepare mutexes for thread starts
-	pthread_t thread;
-	pthread_mutex_t mtx_parameter_transported;
-	pthread_cond_t cond_parameter_transported;
-	pthread_mutex_init(&mtx_parameter_transported, NULL);
-	pthread_cond_init(&cond_parameter_transported, NULL);
-	
-	int fd_remote;
-	struct thread_helper pthread_args;
-	pthread_args.reg_controller = rc;
-	pthread_args.file_descriptor = &fd_remote;
-	pthread_args.mutex = &mtx_parameter_transported;
-	pthread_args.cond = &cond_parameter_transported;
-	pthread_args.parameter_transported = 0;
-	//
-	//loop for each new accepted connection (create new thread for each)
-	//
-	while(1)
-	{
-		//printf("[reg thread] server awaits connections by clients\n");
-		fd_remote = accept(sfd, NULL, NULL);
-		if(fd_remote==-1) {printf("dderror: accept failed\n"); exit(1);}
-		#if(USS_DAEMON_DEBUG == 1)
-		printf("[reg thread]   server gets connection by client creating new T\n");
-		#endif
-		//reset parameter_transported
-		pthread_args.parameter_transported = 0;
-		
-		//ensure there are no more than USS_NOF_MAX_DISPATCHER_THREADS
-		ret = pthread_mutex_lock(&rc->reg_mutex);
-		if(ret != 0) dexit("thread_mutex_lock");
-		while(rc->get_nof_new_regs() >= USS_NOF_MAX_DISPATCHER_THREADS)
-		{
-			ret = pthread_cond_wait(&rc->reg_cond, &rc->reg_mutex);
-			if(ret != 0) dexit("thread_cond_wait");
-		}
-		ret = pthread_mutex_unlock(&rc->reg_mutex);
-		if(ret != 0) dexit("thread_mutex_unlock");
-		
-		//create worker thread
-		ret = pthread_create(&thread, NULL, handle_incoming_registration, (void*)&pthread_args);
-		if(ret != 0) {dexit("creating thread");}
-		
-		//ensure parameters have been successfully acquired by worker thread
-		ret = pthread_mutex_lock(pthread_args.mutex);
-		if(ret != 0) dexit("thread_mutex_lock");
-		while(pthread_args.parameter_transported == 0)
-		{
-			ret = pthread_cond_wait(pthread_args.cond, pthread_args.mutex);
-			if(ret != 0) dexit("thread_cond_wait");
-		}
-		ret = pthread_mutex_unlock(pthread_args.mutex);
-		if(ret != 0) dexit("thread_mutex_unlock");
-	}
-	
-	//free socket
-	ret = close(sfd);
-	if(ret==-1) {printf("dderror: closing server socket failed\n\n"); exit(1);}
-	else{printf("[reg t] shutdown of registration thread\n");}
-	//free meta_sched_info_short transport struct?? -> no only malloc'ed memory needs free
-	return NULL;
-}
+#include "./uss_daemon.h"
+#include "../common/uss_tools.h"
+#include "../common/uss_fifo.h"
+#include "../common/uss_rtsig.h"
+#include "./uss_registration_controller.h"
+#include "./uss_scheduler.h"
+
+using namespace std;
+
+//////////////////////////////////////////////
+//											//
+// class uss_registration_controller		//
+// interface definitions					//
+//											//
+//////////////////////////////////////////////
+
+/***************************************\
+* constructor and destructor			*
+\***************************************/
+uss_registration_controller::uss_registration_controller(class uss_comm_controller *cc)
+{
+	//creator thread should be main thread here
+	creator_thread = pthread_self();
+	
+	//save link to communication controller (to setup connections during registration procedure)
+	this->cc = cc;
+	
+	//prepare mutex
+	if(pthread_mutex_init(&reg_mutex, NULL) != 0) {printf("error with mutex init\n"); exit(-1);}
+	
+	//prepare wakeup of main thread and registration thread
+	new_reg_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(new_reg_fd == -1) {printf("error with eventfd\n"); exit(-1);}
+	finished_reg_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(finished_reg_fd == -1) {printf("error with eventfd\n"); exit(-1);}
+}
+
+
+uss_registration_controller::~uss_registration_controller()
+{
+	printf("reg_table destroyed\n");
+	close(new_reg_fd);
+	close(finished_reg_fd);
+	pthread_mutex_destroy(&reg_mutex);
+}
+
+
+/***************************************\
+* reg_*_table add and remove			*
+\***************************************/
+/*
+ * a reg_pending_entry should be removed if the scheduler has made
+ * its decision
+ */
+int uss_registration_controller::remove_reg_pending_entry(int h)
+{
+	int ret;
+	ret = pthread_mutex_lock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	//remove
+	reg_pending_table.erase(h);
+	
+	ret = pthread_mutex_unlock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+	return 0;
+}
+
+
+/*
+ * upon each new registration attempt an entry will be in this table
+ * until the scheduler has either accepted or declined it
+ */
+int uss_registration_controller::add_reg_pending_entry(struct meta_sched_addr_info *msai, int fd, int request_id, int index)
+{
+	//
+	//get a fresh handle for this request
+	//
+	int handle = this->handles.get();
+	if(handle < 0) {printf("(derror) problem when getting a handle (all USS_MAX_HANDLES in use)"); return -1;}
+	int ret;
+	
+	//
+	//prepare uss_reg_entry
+	//
+	struct uss_reg_pending_entry entry;
+	entry.handle = handle;
+	entry.msai = (*msai);
+	entry.status = USS_CONTROL_NOT_PROCESSED;
+	entry.retry_ms = 0;
+	entry.fd = fd;
+	entry.request_id = request_id;
+	entry.index = index;
+	
+	//
+	//insert and inizialize into registration table
+	//
+	ret = pthread_mutex_lock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	//insert
+	reg_pending_table.insert(make_pair(handle, entry));
+	
+	ret = pthread_mutex_unlock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+	return handle;
+}
+
+/*
+ * this is called by schedulers cleanup/is_finished method
+ * COMMENT: also removes from the address from addr_table
+ */
+int uss_registration_controller::remove_reg_addr_entry(int h)
+{
+	int ret;
+	
+	struct uss_address a = get_address_of_handle(h);
+	
+	/*protect addr_table (because we do a find on it in some other thread)*/
+	ret = pthread_mutex_lock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	addr_table.erase(a);
+	reg_table.erase(h);
+	
+	ret = pthread_mutex_unlock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+	return 0;
+}
+
+
+/*
+ * this is only called when the scheduler accepted an reg_pending_entry
+ */
+int uss_registration_controller::add_reg_addr_entry(int handle, struct uss_address *addr)
+{
+	int ret;
+	ret = pthread_mutex_lock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	//insert
+	reg_table.insert(make_pair(handle, (*addr)));
+	addr_table.insert(make_pair((*addr), handle));
+	
+	ret = pthread_mutex_unlock(&reg_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+	return 0;
+}
+
+
+/*
+ * print an entry selected by handle h
+ */
+int uss_registration_controller::print_entry(int h)
+{
+	//printf("print test: %i %i \n", reg_table[h].msi_short.length, reg_table[h].msi_short.pid);	
+	return 0;
+}
+
+
+/***************************************\
+* registration helpers					*
+\***************************************/
+/*
+ * registration thread: hand over new pending entries to the scheduler
+ * (one wakeup of main thread for all of them)
+ */
+void uss_registration_controller::queue_new_regs(vector<int> *handles)
+{
+	int ret;
+	ret = pthread_mutex_lock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
+	
+	this->new_regs.insert(this->new_regs.end(), handles->begin(), handles->end());
+	
+	ret = pthread_mutex_unlock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}	
+	
+	//wake up main thread
+	uint64_t one = 1;
+	if(write(this->new_reg_fd, &one, sizeof(uint64_t)) != sizeof(uint64_t) && errno != EAGAIN)
+	{derr("could not notify main thread of new registration"); exit(-1);}
+	return;
+}
+
+
+/*
+ * scheduler: fetch up to max new registrations (oldest first)
+ *
+ * returns number of handles (and their msai) written
+ */
+int uss_registration_controller::get_new_regs(int *handles, struct meta_sched_addr_info *msais, int max)
+{
+	int ret, n = 0;
+	ret = pthread_mutex_lock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
+	
+	for(; n < max && n < (int)this->new_regs.size(); n++)
+	{
+		handles[n] = this->new_regs[n];
+		msais[n] = this->reg_pending_table[handles[n]].msai;
+	}
+	this->new_regs.erase(this->new_regs.begin(), this->new_regs.begin() + n);
+	
+	ret = pthread_mutex_unlock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}	
+	
+	return n;
+}
+
+
+/*
+ * scheduler: put responses into reg_pending_table
+ * and let the registration thread answer all of them
+ */
+void uss_registration_controller::finish_registrations(int *handles, int *accepted, int *retry_ms, int n)
+{
+	int ret;
+	ret = pthread_mutex_lock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
+	
+	for(int i = 0; i < n; i++)
+	{
+		if(accepted[i] != USS_CONTROL_SCHED_ACCEPTED && accepted[i] != USS_CONTROL_SCHED_DECLINED
+		   && accepted[i] != USS_CONTROL_SCHED_RETRY)
+		{
+			//sth odd happend
+			dexit("process_sched_response did sth odd");
+		}
+		this->reg_pending_table[handles[i]].status = accepted[i];
+		this->reg_pending_table[handles[i]].retry_ms = retry_ms[i];
+		this->finished_regs.push_back(this->reg_pending_table[handles[i]]);
+	}
+	
+	ret = pthread_mutex_unlock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}
+	
+	//wake up registration thread
+	uint64_t one = 1;
+	if(write(this->finished_reg_fd, &one, sizeof(uint64_t)) != sizeof(uint64_t) && errno != EAGAIN)
+	{derr("could not notify registration thread of finished registration"); exit(-1);}
+}
+
+
+/*
+ * registration thread: take all registrations the scheduler has decided on
+ */
+void uss_registration_controller::get_finished_regs(vector<struct uss_reg_pending_entry> *entries)
+{
+	int ret;
+	ret = pthread_mutex_lock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
+	
+	entries->swap(this->finished_regs);
+	
+	ret = pthread_mutex_unlock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}
+}
+
+
+/***************************************\
+* handle GET something					*
+\***************************************/
+int uss_registration_controller::get_handle_of_address(struct uss_address searched_address)
+{
+	int ret, final_ret = -1;
+	ret = pthread_mutex_lock(&this->reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	type_addr_table_iterator it = addr_table.find(searched_address);
+	if(it != addr_table.end())
+	{
+		final_ret = (*it).second;
+	}
+	else
+	{
+		dexit("get_handle_of_addres ADDR not found");
+	}
+	
+	ret = pthread_mutex_unlock(&this->reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	return final_ret;
+}
+
+struct uss_address uss_registration_controller::get_address_of_handle(int han)
+{
+	int ret, final_ret = -1;
+	ret = pthread_mutex_lock(&this->reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+	
+	type_reg_table_iterator it = reg_table.find(han);
+	
+	ret = pthread_mutex_unlock(&this->reg_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+	
+	if(it != reg_table.end())
+	{
+		//found handle in table
+		return (*it).second;
+	}
+	else
+	{
+		//error or not found
+		dexit("get_address_of_handle HANDLE not found");
+		struct uss_address error_struct;
+		memset(&error_struct, 0, sizeof(struct uss_address));
+		return error_struct;
+	}
+}
+
+
+struct meta_sched_addr_info uss_registration_controller::get_msai(int handle)
+{
+	int ret;
+	type_reg_pending_table_iterator iter;
+	ret = pthread_mutex_lock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_lock"); exit(-1);}
+	
+	iter = this->reg_pending_table.find(handle);
+	
+	ret = pthread_mutex_unlock(&(this->reg_mutex));
+	if(ret != 0) {derr("problem with pthread_mutex_unlock"); exit(-1);}
+	
+	if(iter != this->reg_pending_table.end())
+	{
+		//success
+		return (*iter).second.msai;
+	}
+	else
+	{
+		//search must not fail, since searching for a specific previously added entry
+		dexit("get_msi failed");
+		struct meta_sched_addr_info fail_msai;
+		return fail_msai; 
+	}
+}
+
+
+////////////////////////////////////////
+//
+//thread for registration
+//using interface class uss_registration_controller
+//
+////////////////////////////////////////
+
+/*
+ * a request of a library
+ * -> first it is read (header + msais), in pieces if needed
+ * -> then it waits until the scheduler decided on all its msais,
+ *    all responses are written back at once
+ */
+struct uss_reg_request
+{
+	struct uss_registration_request header;
+	vector<struct meta_sched_addr_info> msais;
+	vector<int> channels; /*FIFO: channel of each msai (passed with SCM_RIGHTS)*/
+	vector<struct uss_registration_response> responses;
+	int nof_open; /*msais not decided on yet*/
+};
+
+/*
+ * a connection to a library (or to the rtsig multiplexer of a process)
+ * -> it may carry many requests one after the other without waiting
+ *    for their replies, it is closed after the library hung up and
+ *    the last of them has been answered
+ * -> replies are never waited for: what does not fit into the socket
+ *    buffer is queued and sent on EPOLLOUT (a library that does not
+ *    read must not stall the registrations of all others)
+ */
+struct uss_reg_connection
+{
+	ssize_t nof_br; /*bytes read of header and msais of the request being read*/
+	struct uss_reg_request reading;
+	map<int, struct uss_reg_request> open; /*requests waiting for the scheduler (by request_id)*/
+	int hung_up;
+	deque<vector<char> > out; /*replies not sent completely yet*/
+	size_t out_done; /*bytes sent of out.front() (FIFO: the channel went with the first ones)*/
+	int out_armed; /*EPOLLOUT is waited for*/
+};
+typedef map<int, struct uss_reg_connection> type_reg_connections;
+
+/*
+ * a complete msai has been read from fd
+ * -> set up the sending facility (FIFO: on the channel the library
+ *    passed along) and enter a pending entry
+ *
+ * returns new handle or -1 if the registration is declined right away
+ */
+static int register_pending(uss_registration_controller *rc, struct meta_sched_addr_info *transport, int fd, int request_id, int index, int channel)
+{
+	int ret;
+
+	//if this address is already present in daemon reject this request
+	int addr_already_exists = 0;
+	ret = pthread_mutex_lock(&rc->reg_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+
+	/*search with O(log(n)) and check if it has already been present*/
+	type_addr_table_iterator it = rc->addr_table.find(transport->addr);
+	if(it != rc->addr_table.end()) {addr_already_exists = 1;}
+
+	ret = pthread_mutex_unlock(&rc->reg_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+
+	if(addr_already_exists)
+	{
+		struct uss_registration_response resp;
+		memset(&resp, 0, sizeof(struct uss_registration_response));
+		resp.check = USS_CONTROL_SCHED_DECLINED;
+		write(fd, &resp, sizeof(struct uss_registration_response));
+		dexit("WARNING: got incoming registration from same address\n");
+	}
+
+	#if(USS_RTSIG == 1)
+	//agree on how messages are wrapped into a sigval (stored with the address)
+	if(rtsig_negotiate_encoding(&transport->addr) == -1) {dexit("registration: lid fits no common rtsig encoding");}
+	#endif
+
+	//REGISTRATION
+	//setup the sending facility (opening a fifo created by library)
+	rc->cc->install_sender(&transport->addr, channel);
+	#if(USS_SHARED_RUN_ON == 1)
+	if(rc->cc->install_runon_slot(&transport->addr) == -1)
+	{
+		//library went away or named it differently, the daemon goes on
+		derr("could not map run_on slot -> decline registration");
+		rc->cc->uninstall_sender(&transport->addr);
+		return -1;
+	}
+	#endif
+
+	//enter msi_short into registered_table (entrys state will be USS_CONTROL_NOT_PROCESSED)
+	int new_handle = rc->add_reg_pending_entry(transport, fd, request_id, index);
+					 rc->add_reg_addr_entry(new_handle, &transport->addr);
+	if(new_handle == -1) {dexit("could not add reg_entry");}
+
+	#if(USS_DAEMON_DEBUG == 1)
+	printf("[reg t] add_reg_pending_entry with handle = %i\n", new_handle);
+	#endif
+	return new_handle;
+}
+
+/*
+ * send as much of the queued replies of c as possible without blocking
+ * and wait for EPOLLOUT while something is left
+ */
+static void flush_replies(uss_registration_controller *rc, int epoll_fd, int fd, struct uss_reg_connection *c)
+{
+	while(!c->out.empty())
+	{
+		vector<char> *buf = &c->out.front();
+		ssize_t nof_bw;
+#if(USS_FIFO == 1)
+		if(c->out_done == 0)
+		{
+			//pass the channel of the daemon along (shared by all jobs of the request)
+			int daemon_sender = rc->cc->get_daemon_sender();
+			nof_bw = fifo_try_send_channels(fd, &(*buf)[0], buf->size(), &daemon_sender, 1);
+		}
+		else
+#endif
+		nof_bw = send(fd, &(*buf)[c->out_done], buf->size() - c->out_done, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if(nof_bw == -1 && errno == EINTR) {continue;}
+		if(nof_bw == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {break;}
+		if(nof_bw <= 0)
+		{
+			//library went away, nothing left to tell it
+			derr("could not write registration reply");
+			c->out.clear();
+			c->out_done = 0;
+			break;
+		}
+		c->out_done += nof_bw;
+		if(c->out_done == buf->size())
+		{
+			c->out.pop_front();
+			c->out_done = 0;
+			#if(USS_DAEMON_DEBUG == 1)
+			printf("[reg t] finished dispatching a registration request\n");
+			#endif
+		}
+	}
+
+	//(a connection that has hung up is in the epoll set no more)
+	int want_out = !c->out.empty();
+	if(c->hung_up || want_out == c->out_armed) {return;}
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = (want_out) ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+	ev.data.fd = fd;
+	if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1) {dexit("epoll_ctl");}
+	c->out_armed = want_out;
+}
+
+/*
+ * queue the reply (with all responses) of a request for its library
+ */
+static void respond_request(uss_registration_controller *rc, int epoll_fd, int fd, struct uss_reg_connection *c, struct uss_reg_request *r)
+{
+	//reply header and responses go out as one piece
+	c->out.push_back(vector<char>(sizeof(struct uss_registration_reply) + r->responses.size() * sizeof(struct uss_registration_response)));
+	vector<char> *buf = &c->out.back();
+	struct uss_registration_reply *reply = (struct uss_registration_reply*)&(*buf)[0];
+	reply->request_id = r->header.request_id;
+	reply->nof_responses = r->responses.size();
+	memcpy(reply + 1, &r->responses[0], r->responses.size() * sizeof(struct uss_registration_response));
+
+	flush_replies(rc, epoll_fd, fd, c);
+}
+
+/*
+ * a connection is closed when its library hung up and
+ * no request of it is left to answer
+ */
+static void close_connection_if_done(int fd, type_reg_connections *connections)
+{
+	struct uss_reg_connection *c = &(*connections)[fd];
+	if(!c->hung_up || !c->open.empty()) {return;}
+
+	int ret = close(fd);
+	if(ret==-1) {printf("dderror: closing registration socket failed\n\n"); exit(1);}
+	connections->erase(fd);
+}
+
+/*
+ * fill in the response of the scheduler for each msai
+ * that has been decided on
+ * -> requests that are decided on completely are answered
+ */
+static void respond_registrations(uss_registration_controller *rc, int epoll_fd, type_reg_connections *connections)
+{
+	vector<struct uss_reg_pending_entry> finished;
+	rc->get_finished_regs(&finished);
+
+	for(unsigned int i = 0; i < finished.size(); i++)
+	{
+		struct uss_reg_pending_entry *entry = &finished[i];
+		struct uss_reg_connection *c = &(*connections)[entry->fd];
+		struct uss_reg_request *r = &c->open[entry->request_id];
+
+		//fill in registration response
+		struct uss_registration_response *resp = &r->responses[entry->index];
+		memset(resp, 0, sizeof(struct uss_registration_response));
+		resp->check = entry->status;
+		resp->handle = entry->handle;
+		resp->retry_ms = entry->retry_ms;
+		resp->daemon_addr.pid = getpid();
+		#if(USS_FIFO == 1)
+		resp->daemon_addr.fifo = 1;
+		#elif(USS_RTSIG == 1)
+		resp->daemon_addr.lid = 0;
+		resp->daemon_addr.encoding = entry->msai.addr.encoding;
+		#elif(USS_SHM == 1)
+		resp->daemon_addr.shm = 1;
+		#endif
+		resp->client_addr = entry->msai.addr;
+
+		//move from pending to reg
+		rc->remove_reg_pending_entry(entry->handle);
+		if(entry->status != USS_CONTROL_SCHED_ACCEPTED)
+		{
+			//just remove
+			rc->cc->uninstall_sender(&entry->msai.addr);
+			#if(USS_SHARED_RUN_ON == 1)
+			rc->cc->uninstall_runon_slot(&entry->msai.addr);
+			#endif
+			rc->remove_reg_addr_entry(entry->handle);
+
+			//mark this handle as 'done' (lock-free)
+			if(rc->handles.put(entry->handle) == -1) {derr("freed a stale handle");}
+		}
+
+		r->nof_open--;
+		if(r->nof_open == 0)
+		{
+			respond_request(rc, epoll_fd, entry->fd, c, r);
+			c->open.erase(entry->request_id);
+			close_connection_if_done(entry->fd, connections);
+		}
+	}
+}
+
+/*
+ * read (the rest of) the next request from its connection
+ *
+ * returns 1 if the request is complete, 0 if more is to come
+ * and -1 if the library hung up or sent an invalid request
+ */
+static int read_request(int fd, struct uss_reg_connection *c)
+{
+	struct uss_reg_request *r = &c->reading;
+	ssize_t header_len = sizeof(struct uss_registration_request);
+	while(1)
+	{
+		char *buf;
+		ssize_t len;
+		if(c->nof_br < header_len)
+		{
+			buf = ((char*)&r->header) + c->nof_br;
+			len = header_len - c->nof_br;
+		}
+		else
+		{
+			ssize_t offset = c->nof_br - header_len;
+			buf = ((char*)&r->msais[0]) + offset;
+			len = r->msais.size() * sizeof(struct meta_sched_addr_info) - offset;
+		}
+
+#if(USS_FIFO == 1)
+		//collect the channels in order, the i-th belongs to the i-th msai
+		int channels[USS_MAX_CHANNELS_PER_MESSAGE];
+		int nof_channels = 0;
+		ssize_t nof_br = fifo_recv_channels(fd, buf, len, channels, USS_MAX_CHANNELS_PER_MESSAGE, &nof_channels);
+		r->channels.insert(r->channels.end(), channels, channels + nof_channels);
+#else
+		ssize_t nof_br = read(fd, buf, len);
+#endif
+		if(nof_br == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {return 0;}
+		if(nof_br == -1 && errno == EINTR) {continue;}
+		if(nof_br <= 0) {return -1;}
+
+		c->nof_br += nof_br;
+		if(c->nof_br == header_len)
+		{
+			if(r->header.nof_msai < 1 || r->header.nof_msai > USS_MAX_REGISTRATION_REQUEST) {return -1;}
+			if(c->open.count(r->header.request_id) != 0) {return -1;}
+			r->msais.resize(r->header.nof_msai);
+		}
+		else if(c->nof_br == header_len + (ssize_t)(r->msais.size() * sizeof(struct meta_sched_addr_info)))
+		{
+			#if(USS_FIFO == 1)
+			if(r->channels.size() != r->msais.size()) {return -1;}
+			#endif
+			return 1;
+		}
+	}
+}
+
+/*
+ * hand the msais of a complete request to the scheduler (as part of
+ * the next batch) and start reading the next request of c
+ */
+static void register_request(uss_registration_controller *rc, int epoll_fd, int fd, struct uss_reg_connection *c, vector<int> *new_handles)
+{
+	int request_id = c->reading.header.request_id;
+	struct uss_reg_request *r = &c->open[request_id];
+	r->header = c->reading.header;
+	r->msais.swap(c->reading.msais);
+	r->channels.swap(c->reading.channels);
+	r->responses.resize(r->msais.size());
+	r->nof_open = r->msais.size();
+
+	for(unsigned int j = 0; j < r->msais.size(); j++)
+	{
+		#if(USS_FIFO == 1)
+		int channel = r->channels[j];
+		#else
+		int channel = -1;
+		#endif
+		int new_handle = register_pending(rc, &r->msais[j], fd, request_id, j, channel);
+		if(new_handle == -1)
+		{
+			//nothing for the scheduler to decide on
+			struct uss_registration_response *resp = &r->responses[j];
+			memset(resp, 0, sizeof(struct uss_registration_response));
+			resp->check = USS_CONTROL_SCHED_DECLINED;
+			resp->client_addr = r->msais[j].addr;
+			r->nof_open--;
+			continue;
+		}
+		new_handles->push_back(new_handle);
+	}
+	if(r->nof_open == 0)
+	{
+		respond_request(rc, epoll_fd, fd, c, r);
+		c->open.erase(request_id);
+	}
+
+	c->nof_br = 0;
+	c->reading.msais.clear();
+	c->reading.channels.clear();
+}
+
+/*
+ * start_handle_incomming_registrations()
+ *
+ * (created as a thread)
+ *
+ * single threaded nonblocking server for all registrations
+ * -> accepts connections and reads their requests (in pieces if needed,
+ *    a connection may send many requests without waiting for replies)
+ * -> hands the msais of complete ones as a batch to the scheduler (main thread)
+ * -> writes the reply of a request once the scheduler has decided on all its msais
+ *    (signalled with finished_reg_fd)
+ */
+void* start_handle_incoming_registrations(void *ptr)
+{
+	//printf("\n[reg thread] started to handle incoming registrations\n");
+	//detach so this needn't be joined anyhow
+	pthread_detach(pthread_self());
+
+	//
+	//void pointer *ptr is address to registration_controller
+	//
+	uss_registration_controller *rc = (uss_registration_controller*) ptr;
+
+	int sfd, ret;
+	struct sockaddr_un server_addr;
+	//
+	//create a socket
+	//
+	ret = remove(USS_REGISTRATION_DAEMON_SOCKET);
+	if(ret == -1 && errno != ENOENT) {dexit("problem when trying to remove old socket");}
+
+	sfd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(sfd==-1) {printf("dderror: creating socket\n"); return NULL;}
+
+	memset(&server_addr, 0, sizeof(struct sockaddr_un));
+	server_addr.sun_family = AF_UNIX;
+	strncpy(server_addr.sun_path, USS_REGISTRATION_DAEMON_SOCKET, sizeof(server_addr.sun_path)-1);
+
+	ret = bind(sfd, (struct sockaddr*) &server_addr, sizeof(struct sockaddr_un));
+	if(ret==-1) {printf("dderror: binding socket failed\n"); return NULL;}
+
+	ret = listen(sfd, SOMAXCONN);
+	if(ret==-1) {printf("dderror: listen on socket failed\n"); return NULL;}
+	#if(USS_DAEMON_DEBUG == 1)
+	printf("[reg thread]   server listening\n");
+	#endif
+
+	//
+	//wait on listening socket, connections and finished registrations
+	//
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if(epoll_fd == -1) {dexit("epoll_create1");}
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = EPOLLIN;
+	ev.data.fd = sfd;
+	ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sfd, &ev);
+	if(ret == -1) {dexit("epoll_ctl");}
+	ev.data.fd = rc->finished_reg_fd;
+	ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, rc->finished_reg_fd, &ev);
+	if(ret == -1) {dexit("epoll_ctl");}
+
+	type_reg_connections connections;
+	vector<int> new_handles;
+	struct epoll_event events[USS_REGISTRATION_BATCH];
+	uint64_t counter;
+	int nof_events, fd;
+	//
+	//loop for each batch of events
+	//
+	while(1)
+	{
+		nof_events = epoll_wait(epoll_fd, events, USS_REGISTRATION_BATCH, -1);
+		if(nof_events == -1 && errno == EINTR) {continue;}
+		if(nof_events == -1) {printf("dderror: epoll_wait\n"); exit(1);}
+
+		for(int i = 0; i < nof_events; i++)
+		{
+			fd = events[i].data.fd;
+			if(fd == sfd)
+			{
+				//accept all pending connections
+				while((fd = accept4(sfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1)
+				{
+					#if(USS_DAEMON_DEBUG == 1)
+					printf("[reg thread]   server gets connection by client\n");
+					#endif
+					ev.data.fd = fd;
+					ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+					if(ret == -1) {dexit("epoll_ctl");}
+					connections[fd].nof_br = 0;
+					connections[fd].hung_up = 0;
+					connections[fd].out_done = 0;
+					connections[fd].out_armed = 0;
+				}
+				if(errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED) {printf("dderror: accept failed\n"); exit(1);}
+			}
+			else if(fd == rc->finished_reg_fd)
+			{
+				if(read(fd, &counter, sizeof(uint64_t)) == -1 && errno != EAGAIN) {dexit("read finished_reg_fd");}
+				respond_registrations(rc, epoll_fd, &connections);
+			}
+			else
+			{
+				struct uss_reg_connection *c = &connections[fd];
+				if(events[i].events & EPOLLOUT) {flush_replies(rc, epoll_fd, fd, c);}
+				if(!(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {continue;}
+
+				//read all (pipelined) requests the client has sent so far
+				int complete;
+				while((complete = read_request(fd, c)) == 1) {register_request(rc, epoll_fd, fd, c, &new_handles);}
+				if(complete == 0) {continue;}
+
+				//hung up (or garbage): nothing more to read from this connection
+				if(c->nof_br != 0)
+				{
+					derr("received incomplete registration request");
+					for(unsigned int j = 0; j < c->reading.channels.size(); j++) {close(c->reading.channels[j]);}
+				}
+				ret = epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+				if(ret == -1) {dexit("epoll_ctl");}
+				c->hung_up = 1;
+				//its replies are still sent as far as they fit (if it is still listening)
+				close_connection_if_done(fd, &connections);
+			}
+		}
+
+		//hand over all complete registrations at once
+		if(!new_handles.empty())
+		{
+			rc->queue_new_regs(&new_handles);
+			new_handles.clear();
+		}
+	}
+
+	//free socket
+	ret = close(sfd);
+	if(ret==-1) {printf("dderror: closing server socket failed\n\n"); exit(1);}
+	else{printf("[reg t] shutdown of registration thread\n");}
+	return NULL;
+}
@@ -0,0 +1,115 @@
+#ifndef SLAB_H_INCLUDED
+#define SLAB_H_INCLUDED
+
+#include "./uss_daemon.h"
+
+/*
+ * the slab is a store indexed directly by handle
+ *
+ * the slot bits of a handle (see uss_handle.h) are dense and recycled
+ * => they can be used as an index instead of searching a tree
+ * -> each slot remembers the full handle (with generation) it holds,
+ *    a stale handle of a freed slot is not found (checked in O(1))
+ *
+ * entries live in chunks of USS_SLAB_CHUNK_LEN elements
+ * -> a chunk is allocated when its first handle is inserted and
+ *    is never moved or freed before the slab itself is destroyed
+ *    (pointers to entries stay valid as it was the case with stl map)
+ * -> consecutive slots are neighbours in memory
+ *
+ * COMMENT:
+ * the slab does no locking
+ * -> insert/erase are only done by the daemon thread
+ * -> other threads find handles they got from a rq tree (inserted
+ *    before, ordered by the rq tree_mutex) or from a message of a
+ *    client (its owner is published last, so a found entry is complete)
+ */
+template <class T>
+class uss_slab
+{
+	private:
+	struct uss_slab_chunk
+	{
+		T entry[USS_SLAB_CHUNK_LEN];
+		//handle stored in slot or 0 if slot is free
+		int owner[USS_SLAB_CHUNK_LEN];
+	};
+
+	struct uss_slab_chunk *directory[USS_SLAB_DIR_LEN];
+	int nof_entries;
+
+	public:
+	uss_slab()
+	{
+		memset(directory, 0, sizeof(directory));
+		nof_entries = 0;
+	}
+
+	~uss_slab()
+	{
+		for(int i = 0; i < USS_SLAB_DIR_LEN; i++)
+		{
+			if(directory[i] != NULL) {delete directory[i];}
+		}
+	}
+
+	/*
+	 * returns the entry of handle or NULL if handle is not in slab
+	 */
+	T* find(int handle)
+	{
+		if(handle <= 0) {return NULL;}
+		int slot = handle & USS_HANDLE_INDEX_MASK;
+		struct uss_slab_chunk *c = __atomic_load_n(&directory[slot >> USS_SLAB_CHUNK_SHIFT], __ATOMIC_ACQUIRE);
+		if(c == NULL) {return NULL;}
+		int i = slot & (USS_SLAB_CHUNK_LEN - 1);
+		if(__atomic_load_n(&c->owner[i], __ATOMIC_ACQUIRE) != handle) {return NULL;}
+		return &c->entry[i];
+	}
+
+	/*
+	 * copies entry into the slot of handle
+	 * returns the stored entry or NULL if slot is taken (or handle invalid)
+	 */
+	T* insert(int handle, const T& entry)
+	{
+		if(handle <= 0) {return NULL;}
+		int slot = handle & USS_HANDLE_INDEX_MASK;
+		struct uss_slab_chunk *c = directory[slot >> USS_SLAB_CHUNK_SHIFT];
+		if(c == NULL)
+		{
+			c = new uss_slab_chunk;
+			memset(c->owner, 0, sizeof(c->owner));
+			__atomic_store_n(&directory[slot >> USS_SLAB_CHUNK_SHIFT], c, __ATOMIC_RELEASE);
+		}
+		int i = slot & (USS_SLAB_CHUNK_LEN - 1);
+		if(c->owner[i] != 0) {return NULL;}
+		c->entry[i] = entry;
+		__atomic_store_n(&c->owner[i], handle, __ATOMIC_RELEASE);
+		nof_entries++;
+		return &c->entry[i];
+	}
+
+	/*
+	 * returns the number of removed entries
+	 */
+	int erase(int handle)
+	{
+		if(handle <= 0) {return 0;}
+		int slot = handle & USS_HANDLE_INDEX_MASK;
+		struct uss_slab_chunk *c = directory[slot >> USS_SLAB_CHUNK_SHIFT];
+		if(c == NULL) {return 0;}
+		int i = slot & (USS_SLAB_CHUNK_LEN - 1);
+		if(c->owner[i] != handle) {return 0;}
+		__atomic_store_n(&c->owner[i], 0, __ATOMIC_RELEASE);
+		nof_entries--;
+		return 1;
+	}
+
+	int size()
+	{
+		return nof_entries;
+	}
+};
+
+#endif
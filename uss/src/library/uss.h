@@ -1,79 +1,142 @@
-#ifndef LIBRARY_H_INCLUDED
-#define LIBRARY_H_INCLUDED
-
-/*
- * this equals the number of elements in enum
- * uss_supported_accelerators
- * 
- * (!) decrement with care
- */
-#define USS_NOF_SUPPORTED_ACCEL 20
-
-
-/*
- * this enum contains all supported accelerator types
- * for each of them, it is ensured, that they cooperate
- * with the USS
- *
- * (!) set USS_NOF_SUPPORTED_ACCEL correspondingly
- * (!) max value must be smaller than USS_NOF_SUPPORTED_ACCEL
- *
- */
-enum uss_supported_accelerators
-{
-	USS_ACCEL_TYPE_IDLE = 0,
-	USS_ACCEL_TYPE_CPU = 1,
-	USS_ACCEL_TYPE_CUDA = 4, 
-	USS_ACCEL_TYPE_FPGA = 5,
-	USS_ACCEL_TYPE_STREAM = 6,
-	USS_ACCEL_TYPE_ELEVEN = 9
-};
-
-
-/*
- * to measure the affinity of user code to the supported
- * accelerator types (as listed in uss_supported_accelerators)
- * the programmer of an application has to tell the USS
- * how good his algorithm works on which accelerator
- * 
- * to do so he fills the meta_sched_info structure that holds
- * a list containing an entry for each accelertor the
- * applications support which in turn is a subset of all
- * accelerators supported by the USS
- * 
- * 10: very good affinity
- * 1: bad affinity
- * 0: not supported (default for each accel not in this list)
- *
- */
-struct meta_sched_info_element
-{
-	//int accelerator_type; NOT NEEDED HERE
-	int affinity;
-	int flags; 
-	int (*init)(void*, void*, int);
-	int (*main)(void*, void*, int);
-	int (*free)(void*, void*, int);
-};
-
-
-/*
- * this is a linked list
- * => the user can fill it without worrying about indexes
- *    or completeness of the list
- */
-struct meta_sched_info
-{
-	struct meta_sched_info_element *ptr[USS_NOF_SUPPORTED_ACCEL];
-};
-
-int libuss_fill_msi(struct meta_sched_info *msi, int type, int affinity, int flags, 
-					int (*algo_init_function)(void*, void*, int), 
-					int (*algo_main_function)(void*, void*, int), 
-					int (*algo_free_function)(void*, void*, int));
-
-int libuss_free_msi(struct meta_sched_info *msi);
-
-int libuss_start(struct meta_sched_info *msi, void *md, void *mcp, int *is_finished, int *run_on, int *device_id);
-
-#endif
+#ifndef LIBRARY_H_INCLUDED
+#define LIBRARY_H_INCLUDED
+
+/*
+ * this equals the number of elements in enum
+ * uss_supported_accelerators
+ * 
+ * (!) decrement with care
+ */
+#define USS_NOF_SUPPORTED_ACCEL 20
+
+
+/*
+ * this enum contains all supported accelerator types
+ * for each of them, it is ensured, that they cooperate
+ * with the USS
+ *
+ * (!) set USS_NOF_SUPPORTED_ACCEL correspondingly
+ * (!) max value must be smaller than USS_NOF_SUPPORTED_ACCEL
+ *
+ */
+enum uss_supported_accelerators
+{
+	USS_ACCEL_TYPE_IDLE = 0,
+	USS_ACCEL_TYPE_CPU = 1,
+	USS_ACCEL_TYPE_CUDA = 4, 
+	USS_ACCEL_TYPE_FPGA = 5,
+	USS_ACCEL_TYPE_STREAM = 6,
+	USS_ACCEL_TYPE_ELEVEN = 9
+};
+
+
+/*
+ * to measure the affinity of user code to the supported
+ * accelerator types (as listed in uss_supported_accelerators)
+ * the programmer of an application has to tell the USS
+ * how good his algorithm works on which accelerator
+ * 
+ * to do so he fills the meta_sched_info structure that holds
+ * a list containing an entry for each accelertor the
+ * applications support which in turn is a subset of all
+ * accelerators supported by the USS
+ * 
+ * 10: very good affinity
+ * 1: bad affinity
+ * 0: not supported (default for each accel not in this list)
+ *
+ */
+struct meta_sched_info_element
+{
+	//int accelerator_type; NOT NEEDED HERE
+	int affinity;
+	int flags; 
+	int (*init)(void*, void*, int);
+	int (*main)(void*, void*, int);
+	int (*free)(void*, void*, int);
+};
+
+
+/*
+ * like nice values of processes the priority of an application
+ * is given by a nice value from USS_NICE_MIN (high prio) to USS_NICE_MAX
+ * -> lowering the nice value by one gives about 10% more accelerator
+ *    time compared to other applications
+ */
+#define USS_NICE_MIN -20
+#define USS_NICE_MAX 19
+
+/*
+ * this is a linked list
+ * => the user can fill it without worrying about indexes
+ *    or completeness of the list
+ *
+ * nice: 0 is default (memset msi to 0 before filling)
+ * deadline_ms: 0 is default (no deadline)
+ */
+struct meta_sched_info
+{
+	struct meta_sched_info_element *ptr[USS_NOF_SUPPORTED_ACCEL];
+	int nice;
+	long deadline_ms;
+};
+
+int libuss_fill_msi(struct meta_sched_info *msi, int type, int affinity, int flags, 
+					int (*algo_init_function)(void*, void*, int), 
+					int (*algo_main_function)(void*, void*, int), 
+					int (*algo_free_function)(void*, void*, int));
+
+int libuss_free_msi(struct meta_sched_info *msi);
+
+int libuss_set_nice(struct meta_sched_info *msi, int nice);
+
+/*
+ * a job may have a deadline (wall-clock time from its registration,
+ * kept while a registration the daemon is too busy for is retried)
+ * -> the daemon runs it earliest deadline first ahead of all jobs
+ *    without one, if the deadlines it has accepted before can still
+ *    be met (otherwise it is scheduled like any other job)
+ */
+int libuss_set_deadline(struct meta_sched_info *msi, long deadline_ms);
+
+int libuss_start(struct meta_sched_info *msi, void *md, void *mcp, int *is_finished, int *run_on, int *device_id);
+
+/*
+ * registering many jobs at once (e.g. a worker pool) needs only a
+ * single round trip to the daemon
+ * -> libuss_register_batch registers msi[0..n-1] and returns one
+ *    registration per job in regs
+ * -> each registration is then run (and released) by exactly one
+ *    call of libuss_start_registered, like libuss_start would do
+ * -> libuss_start equals a batch of one
+ * -> a job the daemon is too busy for (admission control) is registered
+ *    again by libuss_start_registered (libuss_start waits for it, too,
+ *    libuss_submit returns at once and the library registers it later)
+ * -> returns USS_ERROR_SCHED_DECLINED_REG if the daemon can not run a
+ *    job at all (its regs[i] is NULL, the other ones must be run anyway)
+ */
+struct uss_registration;
+
+int libuss_register_batch(struct meta_sched_info **msi, int n, struct uss_registration **regs);
+
+int libuss_start_registered(struct uss_registration *reg, void *md, void *mcp, int *is_finished, int *run_on, int *device_id);
+
+/*
+ * libuss_start blocks its thread for the whole life of the job
+ * -> libuss_submit registers the job and returns a handle at once,
+ *    the library runs it in a pool of its own (threads are only
+ *    needed for jobs the daemon has put on an accelerator)
+ * -> libuss_poll tells if the job is done, libuss_wait waits for it
+ *    and releases the handle (returns what libuss_start would)
+ * -> init/main/free of a job may be called from different threads
+ *    of the pool, but never at the same time
+ */
+struct uss_job;
+
+struct uss_job* libuss_submit(struct meta_sched_info *msi, void *md, void *mcp, int *is_finished, int *run_on, int *device_id);
+
+int libuss_poll(struct uss_job *job);
+
+int libuss_wait(struct uss_job *job);
+
+#endif
@@ -1,680 +1,1472 @@
-#include "../common/uss_config.h"
-#include "./uss.h"
-#include "../common/uss_tools.h"
-#include "../common/uss_rtsig.h"
-#include "../common/uss_fifo.h"
-
-//basic
-#include <stdlib.h>
-#include <stdio.h>
-//socket
-#include <sys/socket.h>
-#include <sys/un.h>
-//memeset
-#include <string.h>
-//read and write
-#include <unistd.h>
-
-//////////////////////////////////////////////
-//											//
-// communication functionality				//
-//											//
-//////////////////////////////////////////////
-/*
- * returns a file descriptor or -1 on error
- */
-int libuss_install_receiver(struct uss_address *addr)
-{
-#if(USS_FIFO == 1)
-	return fifo_install_receiver(addr, 1, 0, 1);
-#elif(USS_RTSIG == 1)
-	//SIGRTMIN+1 if receiving from multiplexer
-	addr->pid = getpid();
-	addr->lid = 0;
-	return rtsig_install_receiver(1, 1);
-#endif
-}
-
-/*
- * returns a file descriptor or -1 on error
- */
-int libuss_install_sender(struct uss_address *addr)
-{
-#if(USS_FIFO == 1)
-	return fifo_install_sender(addr, 0, 1, 0);
-#elif(USS_RTSIG == 1)
-	//no need for a senderobject, signals can be simply send away
-	return 0;
-#endif
-}
-
-/***************************************\
-* message send/receive 		 			*
-\***************************************/
-/*
- * return the actual value of run_on
- */
-int update_run_on(int *run_on, int *device_id, int sfd)
-{
-#if(USS_FIFO == 1)
-	struct uss_message m;
-	ssize_t nof_br = fifo_blocking_read(&m, sfd);
-	if(nof_br == sizeof(struct uss_message) /*&& errno != EAGAIN*/)
-	{
-		*run_on = m.accelerator_type;
-		*device_id = m.accelerator_index;
-	}
-	else if(nof_br == (ssize_t)-1 && errno == EAGAIN)
-	{
-		//everything ok made empty nonblocking read
-		//printf("EAGAIN nof_br=%i \n", (int)nof_br);
-	}
-	else if(nof_br == (ssize_t)0)
-	{
-		//EOF read
-		dexit("update_run_on: daemon has crashed!");
-	}
-	else
-	{
-		//printf("so(mess)=%i nof_br=%i \n",(int)sizeof(struct uss_message), (int)nof_br);
-		dexit("update_run_on: read too small");
-	}
-#elif(USS_RTSIG == 1)
-	struct signalfd_siginfo fdsi;
-	ssize_t nof_br = rtsig_blocking_read(sfd, &fdsi);
-	if(nof_br == sizeof(struct signalfd_siginfo))
-	{
-		struct uss_address a;
-		memset(&a, 0, sizeof(struct uss_address));
-		struct uss_message m;
-		convert_int_to_uss(fdsi.ssi_int, &a, &m);
-
-		*run_on = m.accelerator_type;
-		*device_id = m.accelerator_index;
-	}
-	else if(nof_br != sizeof(struct signalfd_siginfo) && errno == EAGAIN)
-	{
-		//everything ok made empty nonblocking read
-	}
-	else
-	{
-		dexit("update_run_on: read too small");	
-	}
-#endif
-	return *run_on;
-}
-
-/*
- * this requires the communication method to use file descriptors
- * that can be made blocking or nonblocking via fcntl
- */
-int waitfor_run_on(int *run_on, int *device_id, int sfd)
-{
-	int flags, ret, final_ret;
-
-	//delete flag: O_NONBLOCK
-	flags = fcntl(sfd, F_GETFL);
-	if(flags == -1) {dexit("waitfor_run_on had problem with fcntl");}
-	flags &= (~O_NONBLOCK);
-	ret = fcntl(sfd, F_SETFL, flags);
-	if(ret == -1) {dexit("waitfor_run_on had problem with fcntl");}
-	
-	//now do blocking read on modified sfd
-	final_ret = update_run_on(run_on, device_id, sfd);
-	
-	//reset flag: O_NONBLOCK
-	flags = fcntl(sfd, F_GETFL);
-	if(flags == -1) {dexit("waitfor_run_on had problem with fcntl");}
-	flags |= O_NONBLOCK;
-	ret = fcntl(sfd, F_SETFL, flags);
-	if(ret == -1) {dexit("waitfor_run_on had problem with fcntl");}
-
-	return final_ret;
-}
-
-/*
- * returns 0 on succes, -1 on error
- */
-int libuss_send_to_daemon(struct uss_address *source_address, struct uss_address *receiver_address, 
-						struct uss_message *message, int daemon_fd)
-{
-	int ret;
-#if(USS_FILE_LOGGING == 1)
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	int fd = open("./benchmark/usslog", O_WRONLY | O_APPEND);
-	if(fd == -1) {dexit("dlog");}
-	char buf[100] = {0x0};
-	sprintf(buf, "%ld %ld : sending message cleanup (%i) to of accelerator_type %i\n", 
-		(long)tv.tv_sec, (long)tv.tv_usec, message->message_type, message->accelerator_type);
-	write(fd, buf, strlen(buf));
-	close(fd);
-#endif
-#if(USS_FIFO == 1)	
-	ret = fifo_send(message, daemon_fd);
-#elif(USS_RTSIG == 1)	
-	//wraps source address (because daemon needs a threads LID) and message into a single int value
-	int wrapped_int = 0;
-	convert_uss_to_int(source_address, message, &wrapped_int);
-	//send to receiver addres (because we send to daemon no receiver LID is needed)
-	ret = rtsig_send(0, receiver_address->pid, wrapped_int);
-#endif
-	return ret;
-}
-
-
-//////////////////////////////////////////////
-//											//
-// registration 							//
-//											//
-//////////////////////////////////////////////
-/*
- * libuss_register_at_daemon
- *
- */
-int libuss_register_at_daemon(struct meta_sched_info *msi, struct uss_address *my_addr, struct uss_address *daemon_addr, int *my_fd, int *daemon_fd)
-{
-	//
-	//validity check
-	//
-	if(!msi) {printf("error: msi is NULL pointer -> quit"); return -1;}
-	
-	//
-	//local variables
-	//
-	int ret;
-	int fd;
-	ssize_t size_ret;
-	struct sockaddr_un target_addr;
-
-	//
-	//create a socket
-	//
-	fd = socket(AF_UNIX, SOCK_STREAM, 0);
-	if(fd == -1) {printf("error creating socket -> quit"); return -1;}
-
-	//
-	//make this thread listen on virtual line
-	//
-	*my_fd = libuss_install_receiver(my_addr);
-	if(*my_fd == -1) 
-	{
-		printf("(problem with receiver installation)\n");
-		return USS_ERROR_GENERAL;
-	}
-
-#if(USS_RTSIG == 1)
-	libuss_start_multiplexer(); //will start only if not active yet
-#endif
-
-	//
-	//connect to daemon
-	//		
-	memset(&target_addr, 0, sizeof(struct sockaddr_un));
-	target_addr.sun_family = AF_UNIX;
-	
-#if(USS_FIFO == 1)	
-	strncpy(target_addr.sun_path, USS_REGISTRATION_DAEMON_SOCKET, sizeof(target_addr.sun_path)-1);
-#elif(USS_RTSIG == 1)	
-	strncpy(target_addr.sun_path, USS_REGISTRATION_MULTIPLEXER_SOCKET, sizeof(target_addr.sun_path)-1);
-#endif
-
-	ret = connect(fd, (struct sockaddr*) &target_addr, sizeof(struct sockaddr_un));
-	if(ret == -1) {printf("libuss_register error connecting socket -> return \n"); return -1;}
-	
-	//
-	//parse msi into meta_sched_addr_info 
-	//
-	int i;
-	struct meta_sched_addr_info transport;
-	struct meta_sched_info_element *temp = NULL;
-
-	memset(&transport, 0, sizeof(struct meta_sched_addr_info));
-	
-	transport.addr = *my_addr;
-	transport.tid = pthread_self();
-	transport.length = 0;
-	
-	for(i = 0; i < USS_NOF_SUPPORTED_ACCEL; i++)
-	{
-		temp = msi->ptr[i];
-		if(!temp)
-		{
-			//user doesn't want to use this accel
-			continue;
-		}
-		else
-		{
-			if(transport.length >= USS_MAX_MSI_TRANSPORT)
-			{
-				printf("warning: user specified more accelerators than allowed by USS_MAX_MSI_TRANSPORT\n");
-			}
-			else
-			{
-				transport.accelerator_type[transport.length] = i;
-				transport.affinity[transport.length] = temp->affinity;
-				transport.flags[transport.length] = temp->flags;
-				transport.length += 1;
-			}
-		}
-	}
-	//abort if user hasn't set any elements in his msi
-	if(transport.length == 0) {printf("error: user has specified empty msi -> quit\n"); return -1;}
-	
-	//
-	//sort msai using bubble sort
-	//
-	int exchanged;
-	int n = transport.length;
-	do
-	{
-		exchanged = 0;
-		for(i = 0; i < (n-1); i++)
-		{
-			if(transport.affinity[i] < transport.affinity[i+1])
-			{
-				int temp_acc = transport.accelerator_type[i+1];
-				int temp_aff = transport.affinity[i+1];
-				int temp_fla = transport.flags[i+1];
-				transport.accelerator_type[i+1] = transport.accelerator_type[i];
-				transport.affinity[i+1] = transport.affinity[i];
-				transport.flags[i+1] = transport.flags[i];
-				transport.accelerator_type[i] = temp_acc;
-				transport.affinity[i] = temp_aff;
-				transport.flags[i] = temp_fla;
-				exchanged = 1;
-			}
-		}
-		n--;
-	} while(exchanged == 1 && n > 0);
-	
-#if(USS_LIBRARY_DEBUG == 1)
-	//printf("\nREGISTRATION\n");
-	//print_msi_short(&transport);
-#endif
-
-	//
-	//send meta_sched_addr_info to server
-	//
-	size_ret = write(fd, &transport, sizeof(struct meta_sched_addr_info));
-	if(size_ret != sizeof(struct meta_sched_addr_info)) {dexit("libuss_register: write too small");}
-	
-	//
-	//read response and analyze for success
-	//
-	struct uss_registration_response resp;
-	ssize_t size_got = 0;
-	while(size_got < (ssize_t)sizeof(struct uss_registration_response))
-	{
-		size_ret = read(fd, ((&resp)+size_got), ((ssize_t)sizeof(struct uss_registration_response) - size_got));
-		if(size_ret == -1) {dexit("libuss_register: general error with read call");}
-		size_got += size_ret;
-	}
-	if(size_ret != sizeof(struct uss_registration_response)) {dexit("libuss_register: read too small or unequal");}
-
-	int check = resp.check;
-	*daemon_addr = resp.daemon_addr;
-	*my_addr = resp.client_addr;
-	
-	if(check == USS_CONTROL_SCHED_ACCEPTED) 
-	{
-		#if(USS_FIFO == 1)
-		#if(USS_LIBRARY_DEBUG == 1)
-		printf("my_addr->fifo=%ld\n", my_addr->fifo);
-		#endif
-		*daemon_fd = libuss_install_sender(daemon_addr);
-		if(*daemon_fd == -1) 
-		{
-			printf("(problem with sender installation)\n");
-			close(fd);
-			return USS_ERROR_GENERAL;
-		}
-		#elif(USS_RTSIG == 1)
-		//sending signals needs no senderobject
-		#endif
-
-		#if(USS_LIBRARY_DEBUG == 1)
-		printf("(succesfully transported msi and acceped by sched)\n");	
-		#endif		
-		close(fd);
-		return 0;
-	}
-	else if(check == USS_CONTROL_SCHED_DECLINED)
-	{
-		dexit("(scheduler did not accept registration)\n");
-		ret = close(fd);
-		return USS_ERROR_SCHED_DECLINED_REG;
-	}
-	return -1;
-}
-
-
-//////////////////////////////////////////////
-//											//
-// main library functionality				//
-//											//
-//////////////////////////////////////////////
-/*
- * libuss_start
- *
- * provides main algorithm
- *
- * (dont use function pointer binding here, because it would
- *  require a rebind each time an accelerator is chosen
- *  -> maybe solve by inline calculation?)
- */
-int libuss_start(struct meta_sched_info *msi, void *md, void *mcp, int *is_finished, int *run_on, int *device_id)
-{
-	//
-	//local variables
-	//
-	int ret;
-	
-	/*
-	 *run_on variable is provided from outside what allows other threads to check this ones status
-	 */
-	*run_on = USS_ACCEL_TYPE_IDLE;
-	*device_id = 0;
-
-	//
-	//benchmark variables
-	//
-	#if(BENCHMARK_REGISTRATION_TIME == 1)
-	struct timespec ts;
-	#endif
-	#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
-	struct timespec cst;
-	uint64_t cst_init_ns = 0; uint64_t cst_clean_ns = 0;
-	char buf[100] = {0x0}; int bench_fd;
-	#endif
-
-	//
-	//register at uss (fails if no daemon is started)
-	//
-	struct uss_address my_addr, daemon_addr;
-	memset(&my_addr, 0, sizeof(struct uss_address));	
-	memset(&daemon_addr, 0, sizeof(struct uss_address));
-	int my_fd;
-	int daemon_fd;
-
-	#if(BENCHMARK_REGISTRATION_TIME == 1)
-	if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {dexit("clock_gettime() failed");}
-	uint64_t regtime_start_ns = ts.tv_sec*(1000000000) + ts.tv_nsec;
-	#endif
-
-	ret = libuss_register_at_daemon(msi, &my_addr, &daemon_addr, &my_fd, &daemon_fd);
-
-	#if(BENCHMARK_REGISTRATION_TIME == 1)
-	if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {dexit("clock_gettime() failed");}
-	uint64_t regtime_stop_ns = ts.tv_sec*(1000000000) + ts.tv_nsec;
-	printf("%llu\n", (unsigned long long int)(regtime_stop_ns - regtime_start_ns));
-	#endif
-	
-	if(ret == -1) {printf("registering at daemon unsuccessful -> quit\n"); return USS_ERROR_GENERAL;}
-	if(ret == USS_ERROR_SCHED_DECLINED_REG) {printf("scheduler declined registration\n"); return USS_ERROR_SCHED_DECLINED_REG;}
-	if(ret == USS_ERROR_TRANSPORT) {printf("transport error occured\n"); return USS_ERROR_TRANSPORT;}
-	
-	struct meta_sched_info_element *selected;
-	struct uss_message curr_message;
-	int current_device_id;
-	int do_main_atleast_once = 0;	
-	
-	//
-	//main functionality
-	//
-	//update once
-	update_run_on(run_on, device_id, my_fd);
-	//loop
-	while (!(*is_finished))
-	{
-		switch(*run_on)
-		{
-		case USS_ACCEL_TYPE_CUDA:
-			#if(USS_LIBRARY_DEBUG == 1)
-			printf("case: run CUDA\n");
-			#endif
-			current_device_id = *device_id;
-			do_main_atleast_once = 0;
-			selected = msi->ptr[USS_ACCEL_TYPE_CUDA];
-			
-			#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
-			if(clock_gettime(CLOCK_MONOTONIC, &cst) != 0) {dexit("clock_gettime() failed");}
-			cst_init_ns = cst.tv_sec*(1000000000) + cst.tv_nsec;
-			bench_fd = open("./benchmark/cstlog", O_WRONLY | O_APPEND); if(bench_fd == -1) {dexit("bench_cst");}
-			memset(buf, 0, (size_t)100);
-			sprintf(buf, "i %lld\n", (long long int)(cst_init_ns)); //=time (ns) when this writer is before init
-			write(bench_fd, buf, strlen(buf)); 
-			memset(buf, 0, (size_t)100);
-			sprintf(buf, "c %lld\n", (long long int)(cst_clean_ns)); //=time (ns) when this writer did a cleanup
-			write(bench_fd, buf, strlen(buf)); 			
-			close(bench_fd);
-			#endif
-			
-			selected->init(md, mcp, current_device_id);
-			
-			while(((USS_ACCEL_TYPE_CUDA == *run_on && current_device_id == *device_id) || do_main_atleast_once == 0)
-					&& !(*is_finished))
-			{
-			selected->main(md, mcp, current_device_id);
-			update_run_on(run_on, device_id, my_fd);
-			do_main_atleast_once = 1;
-			}
-			
-			selected->free(md, mcp, current_device_id);
-			
-			#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
-			if(clock_gettime(CLOCK_MONOTONIC, &cst) != 0) {dexit("clock_gettime() failed");}
-			cst_clean_ns = cst.tv_sec*(1000000000) + cst.tv_nsec;
-			#endif
-			
-			if((*is_finished)) 
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_ISFINISHED;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_CUDA;
-				curr_message.accelerator_index = current_device_id;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			else
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_CLEANUP_DONE;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_CUDA;
-				curr_message.accelerator_index = current_device_id;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			break;
-			
-		case USS_ACCEL_TYPE_FPGA:
-			#if(USS_LIBRARY_DEBUG == 1)
-			printf("case: run FPGA\n");
-			#endif			
-			current_device_id = *device_id;
-			do_main_atleast_once = 0;
-			selected = msi->ptr[USS_ACCEL_TYPE_FPGA];
-			
-			selected->init(md, mcp, current_device_id);
-			
-			while(((USS_ACCEL_TYPE_FPGA == *run_on && current_device_id == *device_id) || do_main_atleast_once == 0)
-					&& !(*is_finished))
-			{
-			selected->main(md, mcp, current_device_id);
-			update_run_on(run_on, device_id, my_fd);
-			do_main_atleast_once = 1;
-			}
-			
-			selected->free(md, mcp, current_device_id);
-			
-			if((*is_finished)) 
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_ISFINISHED;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_FPGA;
-				curr_message.accelerator_index = current_device_id;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			else
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_CLEANUP_DONE;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_FPGA;
-				curr_message.accelerator_index = current_device_id;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			break;
-
-		case USS_ACCEL_TYPE_STREAM:
-			#if(USS_LIBRARY_DEBUG == 1)
-			printf("case: run FPGA\n");
-			#endif			
-			current_device_id = *device_id;
-			do_main_atleast_once = 0;
-			selected = msi->ptr[USS_ACCEL_TYPE_STREAM];
-			
-			selected->init(md, mcp, current_device_id);
-			
-			while(((USS_ACCEL_TYPE_STREAM == *run_on && current_device_id == *device_id) || do_main_atleast_once == 0)
-					&& !(*is_finished))
-			{
-			selected->main(md, mcp, current_device_id);
-			update_run_on(run_on, device_id, my_fd);
-			do_main_atleast_once = 1;
-			}
-			
-			selected->free(md, mcp, current_device_id);
-			
-			if((*is_finished)) 
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_ISFINISHED;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_STREAM;
-				curr_message.accelerator_index = current_device_id;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			else
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_CLEANUP_DONE;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_STREAM;
-				curr_message.accelerator_index = current_device_id;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			break;
-			
-		case USS_ACCEL_TYPE_CPU:
-			#if(USS_LIBRARY_DEBUG == 1)
-			printf("case: run CPU\n");
-			#endif
-			selected = msi->ptr[USS_ACCEL_TYPE_CPU];
-			selected->init(md, mcp, 0);
-			
-			while(USS_ACCEL_TYPE_CPU == *run_on && !(*is_finished))
-			{
-			selected->main(md, mcp, 0);
-			update_run_on(run_on, device_id, my_fd);
-			/*CPU has no do_main_atleaat_once because its init/cleanup cost are low*/
-			}
-			
-			selected->free(md, mcp, 0);
-			if((*is_finished)) 
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_ISFINISHED;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_CPU;
-				curr_message.accelerator_index = 0;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			else
-			{
-				#if(USS_FIFO == 1)	
-				curr_message.address = my_addr;
-				#endif
-				curr_message.message_type = USS_MESSAGE_CLEANUP_DONE;
-				curr_message.accelerator_type = USS_ACCEL_TYPE_CPU;
-				curr_message.accelerator_index = 0;
-				ret = libuss_send_to_daemon(&my_addr, &daemon_addr, &curr_message, daemon_fd);
-				if(ret != 0) {dexit("library could not send message!!");}
-			}
-			break;
-			
-		case USS_ACCEL_TYPE_IDLE:
-			/*fallthrough to default
-			 */
-			 
-		default:
-#if(USS_LIBRARY_DEBUG == 1)
-			printf("case: IDLE\n");
-#endif
-			//this app thread has been 'idled' by daemon -> cant do anything until a message from daemon
-			waitfor_run_on(run_on, device_id, my_fd);
-			break;
-			
-		}//end switch
-	}//end main while
-
-	//
-	//cleanup by closing the file descriptors
-	//
-	close(my_fd);
-	close(daemon_fd);
-
-	return ret;
-}
-
-
-//////////////////////////////////////////////
-//											//
-// helper for creating an msi				//
-//											//
-//////////////////////////////////////////////
-/*
- * libuss_msi_insert
- *
- */
-int libuss_fill_msi(struct meta_sched_info *msi, int type, int affinity, int flags, 
-					int (*algo_init_function)(void*, void*, int), 
-					int (*algo_main_function)(void*, void*, int), 
-					int (*algo_free_function)(void*, void*, int))
-{
-	msi->ptr[type] = (struct meta_sched_info_element*) malloc(sizeof(struct meta_sched_info_element));
-	struct meta_sched_info_element *element = msi->ptr[type];
-	if(!element) {printf("Error with malloc\n"); return -1;}
-
-	element->affinity = affinity;
-	element->flags = flags;
-	element->init = algo_init_function;
-	element->main = algo_main_function;
-	element->free = algo_free_function;
-	
-	return 0;
-}
-
-int libuss_free_msi(struct meta_sched_info *msi)
-{
-	for(int f = 0; f<USS_NOF_SUPPORTED_ACCEL; f++)
-	{
-		if(msi->ptr[f] != NULL) {free(msi->ptr[f]);}
-	}
-	return 0;
-}
+#include "../common/uss_config.h"
+#include "./uss.h"
+#include "../common/uss_tools.h"
+#include "../common/uss_rtsig.h"
+#include "../common/uss_fifo.h"
+#include "../common/uss_shm.h"
+
+//basic
+#include <stdlib.h>
+#include <stdio.h>
+//socket
+#include <sys/socket.h>
+#include <sys/un.h>
+//memeset
+#include <string.h>
+//read and write
+#include <unistd.h>
+//ready jobs of the executor
+#include <deque>
+
+//////////////////////////////////////////////
+//											//
+// communication functionality				//
+//											//
+//////////////////////////////////////////////
+/*
+ * used to measure the switch cost (init and free) reported to daemon
+ */
+static uint64_t libuss_get_time_ns()
+{
+	struct timespec ts;
+	if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {dexit("clock_gettime() failed");}
+	return (uint64_t)ts.tv_sec*(1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * FIFO: channel is the write end to be passed to the daemon
+ * (-1 for other transports)
+ *
+ * returns a file descriptor or -1 on error
+ */
+int libuss_install_receiver(struct uss_address *addr, int *channel)
+{
+	*channel = -1;
+#if(USS_FIFO == 1)
+	return fifo_install_receiver(addr, channel, 1);
+#elif(USS_RTSIG == 1)
+	//SIGRTMIN+1 if receiving from multiplexer
+	addr->pid = getpid();
+	addr->lid = 0;
+	//offer the best encoding, the daemon answers with the one to use
+	addr->encoding = USS_RTSIG_ENCODING_BEST;
+	return rtsig_install_receiver(1, 1);
+#elif(USS_SHM == 1)
+	return shm_install_receiver(addr);
+#endif
+}
+
+/*
+ * FIFO: channel is the one the daemon passed with its response
+ * (each job gets a copy of its own)
+ *
+ * returns a file descriptor or -1 on error
+ */
+int libuss_install_sender(struct uss_address *addr, int channel)
+{
+#if(USS_FIFO == 1)
+	return dup(channel);
+#elif(USS_RTSIG == 1)
+	//no need for a senderobject, signals can be simply send away
+	return 0;
+#elif(USS_SHM == 1)
+	//region of the daemon (to ring its doorbell)
+	return shm_install_sender(addr);
+#endif
+}
+
+/***************************************\
+* message send/receive 		 			*
+\***************************************/
+/*
+ * return the actual value of run_on
+ */
+int update_run_on(int *run_on, int *device_id, int sfd, struct uss_runon_slot *slot)
+{
+#if(USS_SHARED_RUN_ON == 1)
+	//latest decision of daemon (no syscall)
+	runon_load(slot, run_on, device_id);
+#elif(USS_FIFO == 1 || USS_SHM == 1)
+	struct uss_message m;
+	#if(USS_FIFO == 1)
+	ssize_t nof_br = fifo_blocking_read(&m, sfd);
+	#else
+	ssize_t nof_br = shm_blocking_read(&m, &shm_region_of_fd(sfd)->to_client, 1);
+	#endif
+	if(nof_br == sizeof(struct uss_message) /*&& errno != EAGAIN*/)
+	{
+		*run_on = m.accelerator_type;
+		*device_id = m.accelerator_index;
+	}
+	else if(nof_br == (ssize_t)-1 && errno == EAGAIN)
+	{
+		//everything ok made empty nonblocking read
+		//printf("EAGAIN nof_br=%i \n", (int)nof_br);
+	}
+	else if(nof_br == (ssize_t)0)
+	{
+		//EOF read
+		dexit("update_run_on: daemon has crashed!");
+	}
+	else
+	{
+		//printf("so(mess)=%i nof_br=%i \n",(int)sizeof(struct uss_message), (int)nof_br);
+		dexit("update_run_on: read too small");
+	}
+#elif(USS_RTSIG == 1)
+	struct signalfd_siginfo fdsi;
+	ssize_t nof_br = rtsig_blocking_read(sfd, &fdsi);
+	if(nof_br == sizeof(struct signalfd_siginfo))
+	{
+		struct uss_address a;
+		memset(&a, 0, sizeof(struct uss_address));
+		struct uss_message m;
+		convert_sigval_to_uss(fdsi.ssi_ptr, &a, &m);
+
+		*run_on = m.accelerator_type;
+		*device_id = m.accelerator_index;
+	}
+	else if(nof_br != sizeof(struct signalfd_siginfo) && errno == EAGAIN)
+	{
+		//everything ok made empty nonblocking read
+	}
+	else
+	{
+		dexit("update_run_on: read too small");	
+	}
+#endif
+	return *run_on;
+}
+
+/*
+ * this requires the communication method to use file descriptors
+ * that can be made blocking or nonblocking via fcntl
+ */
+int waitfor_run_on(int *run_on, int *device_id, int sfd, struct uss_runon_slot *slot)
+{
+#if(USS_SHARED_RUN_ON == 1)
+	//sleep on futex of the slot until daemon decides otherwise
+	runon_wait_change(slot, *run_on, *device_id);
+	return update_run_on(run_on, device_id, sfd, slot);
+#elif(USS_SHM == 1)
+	//a region is no file => sleep on futex of the own ring
+	struct uss_message m;
+	shm_blocking_read(&m, &shm_region_of_fd(sfd)->to_client, 0);
+	*run_on = m.accelerator_type;
+	*device_id = m.accelerator_index;
+	return *run_on;
+#else
+	int flags, ret, final_ret;
+
+	//delete flag: O_NONBLOCK
+	flags = fcntl(sfd, F_GETFL);
+	if(flags == -1) {dexit("waitfor_run_on had problem with fcntl");}
+	flags &= (~O_NONBLOCK);
+	ret = fcntl(sfd, F_SETFL, flags);
+	if(ret == -1) {dexit("waitfor_run_on had problem with fcntl");}
+	
+	//now do blocking read on modified sfd
+	final_ret = update_run_on(run_on, device_id, sfd, slot);
+	
+	//reset flag: O_NONBLOCK
+	flags = fcntl(sfd, F_GETFL);
+	if(flags == -1) {dexit("waitfor_run_on had problem with fcntl");}
+	flags |= O_NONBLOCK;
+	ret = fcntl(sfd, F_SETFL, flags);
+	if(ret == -1) {dexit("waitfor_run_on had problem with fcntl");}
+
+	return final_ret;
+#endif
+}
+
+/*
+ * returns 0 on succes, -1 on error
+ */
+int libuss_send_to_daemon(struct uss_address *source_address, struct uss_address *receiver_address, 
+						struct uss_message *message, int my_fd, int daemon_fd)
+{
+	int ret;
+#if(USS_FILE_LOGGING == 1)
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	int fd = open("./benchmark/usslog", O_WRONLY | O_APPEND);
+	if(fd == -1) {dexit("dlog");}
+	char buf[100] = {0x0};
+	sprintf(buf, "%ld %ld : sending message cleanup (%i) to of accelerator_type %i\n", 
+		(long)tv.tv_sec, (long)tv.tv_usec, message->message_type, message->accelerator_type);
+	write(fd, buf, strlen(buf));
+	close(fd);
+#endif
+#if(USS_FIFO == 1)	
+	ret = fifo_send(message, daemon_fd);
+#elif(USS_RTSIG == 1)	
+	//wraps source address (because daemon needs a threads LID) and message into a single sigval
+	//(source_address carries the encoding negotiated on registration)
+	union sigval sv;
+	convert_uss_to_sigval(source_address, message, &sv);
+	//send to receiver addres (because we send to daemon no receiver LID is needed)
+	ret = rtsig_send(0, receiver_address->pid, sv);
+#elif(USS_SHM == 1)
+	//push into own ring and ring the doorbell of the daemon
+	//(ring full: wait for the dispatcher thread to drain it)
+	struct uss_shm_ring *daemon_ring = &shm_region_of_fd(daemon_fd)->to_daemon;
+	while((ret = shm_send(message, &shm_region_of_fd(my_fd)->to_daemon, daemon_ring)) == -1)
+	{
+		shm_wake(&daemon_ring->doorbell);
+		usleep(100);
+	}
+#endif
+	return ret;
+}
+
+
+//////////////////////////////////////////////
+//											//
+// registration 							//
+//											//
+//////////////////////////////////////////////
+/*
+ * a job that has been registered at the daemon
+ * but not started yet (see uss.h)
+ */
+struct uss_registration
+{
+	struct meta_sched_info *msi;
+	struct uss_address my_addr;
+	struct uss_address daemon_addr;
+	int handle;
+	int my_fd;
+	int daemon_fd;
+	struct uss_runon_slot *run_on_slot;
+	int retry_ms; //> 0: daemon has been too busy, register again after this time
+	uint64_t start_ns; //time of the first attempt (the deadline is relative to it)
+};
+
+/*
+ * parse msi into meta_sched_addr_info (sorted by affinity)
+ * -> the deadline is made absolute from start_ns
+ *
+ * returns -1 if the user has not set any elements in his msi
+ */
+static int libuss_msi_to_msai(struct meta_sched_info *msi, struct uss_address *my_addr, uint64_t start_ns, struct meta_sched_addr_info *transport)
+{
+	int i;
+	struct meta_sched_info_element *temp = NULL;
+
+	memset(transport, 0, sizeof(struct meta_sched_addr_info));
+	
+	transport->addr = *my_addr;
+	transport->tid = pthread_self();
+	transport->length = 0;
+	transport->nice = msi->nice;
+	if(msi->deadline_ms > 0) {transport->deadline = start_ns + (uint64_t)msi->deadline_ms*1000000;}
+	
+	for(i = 0; i < USS_NOF_SUPPORTED_ACCEL; i++)
+	{
+		temp = msi->ptr[i];
+		if(!temp)
+		{
+			//user doesn't want to use this accel
+			continue;
+		}
+		else
+		{
+			if(transport->length >= USS_MAX_MSI_TRANSPORT)
+			{
+				printf("warning: user specified more accelerators than allowed by USS_MAX_MSI_TRANSPORT\n");
+			}
+			else
+			{
+				transport->accelerator_type[transport->length] = i;
+				transport->affinity[transport->length] = temp->affinity;
+				transport->flags[transport->length] = temp->flags;
+				transport->length += 1;
+			}
+		}
+	}
+	//abort if user hasn't set any elements in his msi
+	if(transport->length == 0) {printf("error: user has specified empty msi -> quit\n"); return -1;}
+	
+	//
+	//sort msai using bubble sort
+	//
+	int exchanged;
+	int n = transport->length;
+	do
+	{
+		exchanged = 0;
+		for(i = 0; i < (n-1); i++)
+		{
+			if(transport->affinity[i] < transport->affinity[i+1])
+			{
+				int temp_acc = transport->accelerator_type[i+1];
+				int temp_aff = transport->affinity[i+1];
+				int temp_fla = transport->flags[i+1];
+				transport->accelerator_type[i+1] = transport->accelerator_type[i];
+				transport->affinity[i+1] = transport->affinity[i];
+				transport->flags[i+1] = transport->flags[i];
+				transport->accelerator_type[i] = temp_acc;
+				transport->affinity[i] = temp_aff;
+				transport->flags[i] = temp_fla;
+				exchanged = 1;
+			}
+		}
+		n--;
+	} while(exchanged == 1 && n > 0);
+	
+#if(USS_LIBRARY_DEBUG == 1)
+	//printf("\nREGISTRATION\n");
+	//print_msi_short(transport);
+#endif
+	return 0;
+}
+
+/*
+ * release the receiver of a registration the daemon has not accepted
+ * (the daemon has released its side already)
+ * -> also takes a registration that is only partly installed
+ */
+static void libuss_registration_release(struct uss_registration *reg)
+{
+#if(USS_SHARED_RUN_ON == 1)
+	if(reg->run_on_slot != NULL) {runon_uninstall(reg->run_on_slot, &reg->my_addr, 1);}
+#endif
+#if(USS_SHM == 1)
+	if(reg->my_fd != -1) {shm_uninstall(reg->my_fd, 1);}
+	if(reg->daemon_fd != -1) {shm_uninstall(reg->daemon_fd, 0);}
+#elif(USS_FIFO == 1)
+	if(reg->my_fd != -1) {close(reg->my_fd);}
+	if(reg->daemon_fd != -1) {close(reg->daemon_fd);}
+#else
+	if(reg->my_fd != -1) {close(reg->my_fd);}
+#endif
+	reg->my_fd = -1;
+	reg->daemon_fd = -1;
+	reg->run_on_slot = NULL;
+}
+
+static int libuss_register_at(struct meta_sched_info **msi, int n, struct uss_registration **regs, uint64_t start_ns);
+
+/*
+ * libuss_register_batch
+ *
+ * registers n jobs at the daemon with a single request
+ * -> every job gets a receiver (and run_on slot) of its own,
+ *    but the connection, the round trip and the pass of the daemon's
+ *    main loop are shared by all of them
+ * -> on success regs[i] belongs to msi[i] and is released by
+ *    libuss_start_registered
+ * -> a job the daemon is too busy for (admission control) is queued
+ *    here and registered again by libuss_start_registered
+ * -> on error nothing is left behind and regs[] is all NULL
+ */
+int libuss_register_batch(struct meta_sched_info **msi, int n, struct uss_registration **regs)
+{
+	return libuss_register_at(msi, n, regs, libuss_get_time_ns());
+}
+
+/*
+ * (start_ns: time of the first attempt, kept by a retry => its deadline stays the same)
+ */
+static int libuss_register_at(struct meta_sched_info **msi, int n, struct uss_registration **regs, uint64_t start_ns)
+{
+	//
+	//validity check
+	//
+	if(!msi || !regs) {printf("error: msi is NULL pointer -> quit"); return -1;}
+	if(n < 1 || n > USS_MAX_REGISTRATION_REQUEST) {printf("error: invalid number of jobs to register -> quit"); return -1;}
+#if(USS_RTSIG == 1)
+	//the multiplexer signals a thread => every thread registers itself
+	if(n != 1) {printf("error: batch registration is not supported with USS_RTSIG -> quit"); return -1;}
+#endif
+
+	//
+	//local variables
+	//
+	int ret;
+	int fd;
+	int i;
+	struct sockaddr_un target_addr;
+	socklen_t target_addr_len;
+	struct uss_registration_request request;
+	struct uss_registration_reply *reply;
+	struct meta_sched_addr_info *transport;
+	struct uss_registration_response *resp;
+	int *channels;
+	int declined = 0;
+	int ret_batch = 0;
+	int nof_regs = 0;
+	size_t size_reply;
+#if(USS_FIFO == 1)
+	int daemon_channel = -1;
+	int nof_channels;
+	size_t size_got;
+#endif
+
+	for(i = 0; i < n; i++)
+	{
+		if(!msi[i]) {printf("error: msi is NULL pointer -> quit"); return -1;}
+	}
+
+	//
+	//create a socket
+	//
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd == -1) {printf("error creating socket -> quit"); return -1;}
+
+	transport = (struct meta_sched_addr_info*) malloc(n * sizeof(struct meta_sched_addr_info));
+	//reply header and responses are read as one piece
+	reply = (struct uss_registration_reply*) malloc(sizeof(struct uss_registration_reply) + n * sizeof(struct uss_registration_response));
+	resp = (struct uss_registration_response*)(reply + 1);
+	channels = (int*) malloc(n * sizeof(int));
+	if(!transport || !reply || !channels) {dexit("libuss_register: malloc");}
+	for(i = 0; i < n; i++) {channels[i] = -1; regs[i] = NULL;}
+
+	for(i = 0; i < n; i++)
+	{
+		regs[i] = (struct uss_registration*) malloc(sizeof(struct uss_registration));
+		if(!regs[i]) {dexit("libuss_register: malloc");}
+		memset(regs[i], 0, sizeof(struct uss_registration));
+		regs[i]->msi = msi[i];
+		regs[i]->my_fd = -1;
+		regs[i]->daemon_fd = -1;
+		regs[i]->run_on_slot = NULL;
+		regs[i]->start_ns = start_ns;
+		nof_regs = i + 1;
+
+		//
+		//make this job listen on virtual line
+		//
+		regs[i]->my_fd = libuss_install_receiver(&regs[i]->my_addr, &channels[i]);
+		if(regs[i]->my_fd == -1) 
+		{
+			printf("(problem with receiver installation)\n");
+			ret_batch = USS_ERROR_GENERAL;
+			goto cleanup;
+		}
+#if(USS_SHARED_RUN_ON == 1)
+		//daemon maps it when accepting the registration
+		regs[i]->run_on_slot = runon_install_receiver(&regs[i]->my_addr);
+		if(regs[i]->run_on_slot == NULL) 
+		{
+			printf("(problem with run_on slot installation)\n");
+			ret_batch = USS_ERROR_GENERAL;
+			goto cleanup;
+		}
+#endif
+
+		if(libuss_msi_to_msai(msi[i], &regs[i]->my_addr, start_ns, &transport[i]) == -1) {ret_batch = -1; goto cleanup;}
+	}
+
+#if(USS_RTSIG == 1)
+	libuss_start_multiplexer(); //will start only if not active yet
+#endif
+
+	//
+	//connect to daemon
+	//		
+	memset(&target_addr, 0, sizeof(struct sockaddr_un));
+	target_addr.sun_family = AF_UNIX;
+	
+#if(USS_FIFO == 1 || USS_SHM == 1)	
+	strncpy(target_addr.sun_path, USS_REGISTRATION_DAEMON_SOCKET, sizeof(target_addr.sun_path)-1);
+	target_addr_len = sizeof(struct sockaddr_un);
+#elif(USS_RTSIG == 1)	
+	target_addr_len = libuss_multiplexer_address(&target_addr);
+#endif
+
+	ret = connect(fd, (struct sockaddr*) &target_addr, target_addr_len);
+	if(ret == -1) {printf("libuss_register error connecting socket -> return \n"); ret_batch = -1; goto cleanup;}
+	
+	//
+	//send request and all meta_sched_addr_info to server
+	//
+	//one request per connection => its id only needs to be echoed
+	request.request_id = 0;
+	request.nof_msai = n;
+	ret = socket_transfer(fd, &request, sizeof(struct uss_registration_request), 1);
+	if(ret == -1) {dexit("libuss_register: write too small");}
+#if(USS_FIFO == 1)
+	//pass the channel of each job along with its msai
+	for(i = 0; i < n; i += USS_MAX_CHANNELS_PER_MESSAGE)
+	{
+		int nof_chunk = (n - i < USS_MAX_CHANNELS_PER_MESSAGE) ? (n - i) : USS_MAX_CHANNELS_PER_MESSAGE;
+		ret = fifo_send_channels(fd, &transport[i], nof_chunk * sizeof(struct meta_sched_addr_info), &channels[i], nof_chunk);
+		if(ret == -1) {dexit("libuss_register: write too small");}
+	}
+	//the daemon holds copies of its own now
+	for(i = 0; i < n; i++) {close(channels[i]); channels[i] = -1;}
+#else
+	ret = socket_transfer(fd, transport, n * sizeof(struct meta_sched_addr_info), 1);
+	if(ret == -1) {dexit("libuss_register: write too small");}
+#endif
+	
+	//
+	//read reply and responses (same order) and analyze for success
+	//
+	size_reply = sizeof(struct uss_registration_reply) + n * sizeof(struct uss_registration_response);
+#if(USS_FIFO == 1)
+	//the channel of the daemon comes along with the reply
+	nof_channels = 0;
+	size_got = 0;
+	while(size_got < size_reply)
+	{
+		ssize_t size_ret = fifo_recv_channels(fd, ((char*)reply) + size_got, size_reply - size_got, &daemon_channel, 1, &nof_channels);
+		if(size_ret == -1 && errno == EINTR) {continue;}
+		if(size_ret <= 0) {dexit("libuss_register: read too small or unequal");}
+		size_got += size_ret;
+	}
+	if(nof_channels != 1) {dexit("libuss_register: got no channel of the daemon");}
+#else
+	ret = socket_transfer(fd, reply, size_reply, 0);
+	if(ret == -1) {dexit("libuss_register: read too small or unequal");}
+#endif
+	close(fd);
+	fd = -1;
+	if(reply->request_id != request.request_id || reply->nof_responses != n) {dexit("libuss_register: reply does not match request");}
+
+	for(i = 0; i < n; i++)
+	{
+		regs[i]->daemon_addr = resp[i].daemon_addr;
+		regs[i]->my_addr = resp[i].client_addr;
+		regs[i]->handle = resp[i].handle;
+		regs[i]->retry_ms = 0;
+		
+		if(resp[i].check == USS_CONTROL_SCHED_ACCEPTED) 
+		{
+			#if(USS_FIFO == 1 || USS_SHM == 1)
+			#if(USS_LIBRARY_DEBUG == 1 && USS_FIFO == 1)
+			printf("my_addr->fifo=%ld\n", regs[i]->my_addr.fifo);
+			#endif
+			#if(USS_FIFO == 1)
+			regs[i]->daemon_fd = libuss_install_sender(&regs[i]->daemon_addr, daemon_channel);
+			#else
+			//shm finds the region of the daemon by its address
+			regs[i]->daemon_fd = libuss_install_sender(&regs[i]->daemon_addr, -1);
+			#endif
+			if(regs[i]->daemon_fd == -1) 
+			{
+				printf("(problem with sender installation)\n");
+				ret_batch = USS_ERROR_GENERAL;
+				goto cleanup;
+			}
+			#elif(USS_RTSIG == 1)
+			//sending signals needs no senderobject
+			#endif
+
+			#if(USS_LIBRARY_DEBUG == 1)
+			printf("(succesfully transported msi and acceped by sched)\n");	
+			#endif		
+		}
+		else if(resp[i].check == USS_CONTROL_SCHED_RETRY)
+		{
+			//daemon is too busy => register again when it is started
+			libuss_registration_release(regs[i]);
+			regs[i]->retry_ms = (resp[i].retry_ms > 0) ? resp[i].retry_ms : 1;
+		}
+		else if(resp[i].check == USS_CONTROL_SCHED_DECLINED)
+		{
+			printf("(scheduler did not accept registration)\n");
+			libuss_registration_release(regs[i]);
+			free(regs[i]);
+			regs[i] = NULL;
+			declined = 1;
+		}
+		else
+		{
+			ret_batch = -1;
+			goto cleanup;
+		}
+	}
+	ret_batch = (declined) ? USS_ERROR_SCHED_DECLINED_REG : 0;
+
+cleanup:
+	if(ret_batch != 0 && ret_batch != USS_ERROR_SCHED_DECLINED_REG)
+	{
+		//nothing of this batch is handed to the caller
+		for(i = 0; i < nof_regs; i++)
+		{
+			if(regs[i] == NULL) {continue;}
+			libuss_registration_release(regs[i]);
+			free(regs[i]);
+			regs[i] = NULL;
+		}
+		for(i = 0; i < n; i++)
+		{
+			if(channels[i] != -1) {close(channels[i]);}
+		}
+	}
+	if(fd != -1) {close(fd);}
+#if(USS_FIFO == 1)
+	if(daemon_channel != -1) {close(daemon_channel);}
+#endif
+	free(transport);
+	free(reply);
+	free(channels);
+	return ret_batch;
+}
+
+/*
+ * the time [ms] to wait before a registration is sent again
+ * -> up to 1/USS_ADMISSION_RETRY_JITTER is added to the time the daemon
+ *    has told => jobs told at once do not come back at once
+ */
+static int libuss_registration_delay(struct uss_registration *reg, unsigned int *seed)
+{
+	return reg->retry_ms + rand_r(seed) % (reg->retry_ms / USS_ADMISSION_RETRY_JITTER + 1);
+}
+
+/*
+ * a registration the daemon has been too busy for is registered
+ * again after the time it has told, until it is accepted
+ * (backpressure: the caller is blocked meanwhile)
+ *
+ * returns 0 or the error of the registration (reg is released then)
+ */
+static int libuss_registration_wait(struct uss_registration **reg)
+{
+	int ret;
+	unsigned int seed = (unsigned int)(libuss_get_time_ns() ^ (uint64_t)pthread_self());
+	while((*reg)->retry_ms > 0)
+	{
+		int wait_ms = libuss_registration_delay(*reg, &seed);
+		#if(USS_LIBRARY_DEBUG == 1)
+		printf("(daemon is busy, register again after %i ms)\n", wait_ms);
+		#endif
+		struct timespec ts;
+		ts.tv_sec = wait_ms / 1000;
+		ts.tv_nsec = (long)(wait_ms % 1000) * 1000000;
+		while(nanosleep(&ts, &ts) == -1 && errno == EINTR);
+		
+		struct meta_sched_info *msi = (*reg)->msi;
+		uint64_t start_ns = (*reg)->start_ns;
+		free(*reg);
+		*reg = NULL;
+		ret = libuss_register_at(&msi, 1, reg, start_ns);
+		if(ret != 0) {return ret;}
+	}
+	return 0;
+}
+
+
+//////////////////////////////////////////////
+//											//
+// main library functionality				//
+//											//
+//////////////////////////////////////////////
+/*
+ * libuss_start
+ *
+ * registers a single job and runs it
+ */
+int libuss_start(struct meta_sched_info *msi, void *md, void *mcp, int *is_finished, int *run_on, int *device_id)
+{
+	int ret;
+	struct uss_registration *reg;
+
+	//
+	//benchmark variables
+	//
+	#if(BENCHMARK_REGISTRATION_TIME == 1)
+	struct timespec ts;
+	if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {dexit("clock_gettime() failed");}
+	uint64_t regtime_start_ns = ts.tv_sec*(1000000000) + ts.tv_nsec;
+	#endif
+
+	//
+	//register at uss (fails if no daemon is started)
+	//
+	ret = libuss_register_batch(&msi, 1, &reg);
+
+	#if(BENCHMARK_REGISTRATION_TIME == 1)
+	if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {dexit("clock_gettime() failed");}
+	uint64_t regtime_stop_ns = ts.tv_sec*(1000000000) + ts.tv_nsec;
+	printf("%llu\n", (unsigned long long int)(regtime_stop_ns - regtime_start_ns));
+	#endif
+	
+	if(ret == -1) {printf("registering at daemon unsuccessful -> quit\n"); return USS_ERROR_GENERAL;}
+	if(ret == USS_ERROR_SCHED_DECLINED_REG) {printf("scheduler declined registration\n"); return USS_ERROR_SCHED_DECLINED_REG;}
+	if(ret == USS_ERROR_TRANSPORT) {printf("transport error occured\n"); return USS_ERROR_TRANSPORT;}
+	if(ret != 0) {return ret;}
+
+	return libuss_start_registered(reg, md, mcp, is_finished, run_on, device_id);
+}
+
+/***************************************\
+* job									*
+\***************************************/
+/*
+ * a job that has been registered and is run by the library
+ * (in the thread of libuss_start_registered or by the executor
+ *  if it has been submitted)
+ */
+struct uss_job
+{
+	struct meta_sched_info *msi;
+	void *md;
+	void *mcp;
+	int *is_finished;
+	int *run_on;
+	int *device_id;
+	struct uss_address my_addr;
+	struct uss_address daemon_addr;
+	int handle;
+	int my_fd;
+	int daemon_fd;
+	struct uss_runon_slot *run_on_slot;
+	int ret;
+	#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
+	uint64_t cst_clean_ns;
+	#endif
+
+	//submitted jobs: set once the job is done (see libuss_wait)
+	int done;
+	pthread_mutex_t done_mutex;
+	pthread_cond_t done_cond;
+	//executor: my_fd has been added to the monitor (the first time it waits)
+	int in_monitor;
+	//executor: registration the daemon has been too busy for
+	//(the job is initialized only once it has been accepted)
+	struct uss_registration *reg;
+};
+
+/*
+ * take over the state of the registration (reg is released)
+ */
+static void libuss_job_init(struct uss_job *job, struct uss_registration *reg, void *md, void *mcp, int *is_finished, int *run_on, int *device_id)
+{
+	job->msi = reg->msi;
+	job->md = md;
+	job->mcp = mcp;
+	job->is_finished = is_finished;
+	job->run_on = run_on;
+	job->device_id = device_id;
+	job->my_addr = reg->my_addr;
+	job->daemon_addr = reg->daemon_addr;
+	job->handle = reg->handle;
+	job->my_fd = reg->my_fd;
+	job->daemon_fd = reg->daemon_fd;
+	job->run_on_slot = reg->run_on_slot;
+	job->ret = 0;
+	#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
+	job->cst_clean_ns = 0;
+	#endif
+	free(reg);
+
+	/*
+	 *run_on variable is provided from outside what allows other threads to check this ones status
+	 */
+	*job->run_on = USS_ACCEL_TYPE_IDLE;
+	*job->device_id = 0;
+}
+
+/***************************************\
+* accelerator policy					*
+\***************************************/
+/*
+ * how a job is run on an accelerator type (flags)
+ * -> USS_ACCEL_POLICY_MAIN_ONCE: main runs at least once after init
+ *    (init and free of the type are too expensive to be wasted by
+ *    the daemon switching right away)
+ * -> USS_ACCEL_POLICY_NO_DEVICE: the type has no devices to tell
+ *    apart (device id 0 is passed, a new device id is no switch)
+ */
+#define USS_ACCEL_POLICY_MAIN_ONCE 0x1
+#define USS_ACCEL_POLICY_NO_DEVICE 0x2
+
+/*
+ * returns the policy flags of type
+ * (a new backend only needs an entry here if it differs from default)
+ */
+static int libuss_accel_policy(int type)
+{
+	switch(type)
+	{
+	case USS_ACCEL_TYPE_CPU:
+		//init/cleanup cost of CPU are low
+		return USS_ACCEL_POLICY_NO_DEVICE;
+	default:
+		return USS_ACCEL_POLICY_MAIN_ONCE;
+	}
+}
+
+/*
+ * returns 1 if type is an accelerator a job can be run on
+ * (IDLE and invalid types mean waiting for the daemon)
+ */
+static int libuss_accel_runnable(int type)
+{
+	return (type > USS_ACCEL_TYPE_IDLE && type < USS_NOF_SUPPORTED_ACCEL);
+}
+
+/*
+ * one pass of the main loop of a job
+ * -> runs the job on the accelerator of run_on until the daemon
+ *    decides otherwise (or it is finished) and reports back
+ * -> IDLE: waits for the next decision of the daemon
+ *
+ * (dont use function pointer binding here, because it would
+ *  require a rebind each time an accelerator is chosen
+ *  -> maybe solve by inline calculation?)
+ */
+static void libuss_job_step(struct uss_job *job)
+{
+	int type = *job->run_on;
+	if(!libuss_accel_runnable(type))
+	{
+#if(USS_LIBRARY_DEBUG == 1)
+		printf("case: IDLE\n");
+#endif
+		//this app thread has been 'idled' by daemon -> cant do anything until a message from daemon
+		waitfor_run_on(job->run_on, job->device_id, job->my_fd, job->run_on_slot);
+		return;
+	}
+
+	//
+	//benchmark variables
+	//
+	#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
+	struct timespec cst;
+	uint64_t cst_init_ns = 0;
+	char buf[100] = {0x0}; int bench_fd;
+	#endif
+
+	struct meta_sched_info_element *selected = job->msi->ptr[type];
+	int policy = libuss_accel_policy(type);
+	int current_device_id = (policy & USS_ACCEL_POLICY_NO_DEVICE) ? 0 : *job->device_id;
+	int do_main_atleast_once = (policy & USS_ACCEL_POLICY_MAIN_ONCE) ? 0 : 1;
+	struct uss_message curr_message;
+	int ret;
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	//times of the slice reported to the daemon (no room for them in rtsig)
+	uint64_t switch_start_ns, init_ns, free_ns, main_start_ns, main_ns = 0;
+	uint32_t nof_main = 0;
+	#endif
+
+#if(USS_LIBRARY_DEBUG == 1)
+	printf("case: run accelerator type %i\n", type);
+#endif
+	//the daemon only decides on types of the msai
+	if(selected == NULL) {dexit("daemon put job on an accelerator type it has no implementation of");}
+
+	#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
+	if(type == USS_ACCEL_TYPE_CUDA)
+	{
+	if(clock_gettime(CLOCK_MONOTONIC, &cst) != 0) {dexit("clock_gettime() failed");}
+	cst_init_ns = cst.tv_sec*(1000000000) + cst.tv_nsec;
+	bench_fd = open("./benchmark/cstlog", O_WRONLY | O_APPEND); if(bench_fd == -1) {dexit("bench_cst");}
+	memset(buf, 0, (size_t)100);
+	sprintf(buf, "i %lld\n", (long long int)(cst_init_ns)); //=time (ns) when this writer is before init
+	write(bench_fd, buf, strlen(buf)); 
+	memset(buf, 0, (size_t)100);
+	sprintf(buf, "c %lld\n", (long long int)(job->cst_clean_ns)); //=time (ns) when this writer did a cleanup
+	write(bench_fd, buf, strlen(buf)); 			
+	close(bench_fd);
+	}
+	#endif
+	
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	switch_start_ns = libuss_get_time_ns();
+	#endif
+	selected->init(job->md, job->mcp, current_device_id);
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	init_ns = libuss_get_time_ns() - switch_start_ns;
+	#endif
+	
+	while(((type == *job->run_on && ((policy & USS_ACCEL_POLICY_NO_DEVICE) || current_device_id == *job->device_id)) 
+			|| do_main_atleast_once == 0)
+			&& !(*job->is_finished))
+	{
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	main_start_ns = libuss_get_time_ns();
+	#endif
+	selected->main(job->md, job->mcp, current_device_id);
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	main_ns += libuss_get_time_ns() - main_start_ns;
+	nof_main++;
+	#endif
+	update_run_on(job->run_on, job->device_id, job->my_fd, job->run_on_slot);
+	do_main_atleast_once = 1;
+	}
+	
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	switch_start_ns = libuss_get_time_ns();
+	#endif
+	selected->free(job->md, job->mcp, current_device_id);
+	#if(USS_FIFO == 1 || USS_SHM == 1)
+	free_ns = libuss_get_time_ns() - switch_start_ns;
+	#endif
+	
+	#if(BENCHMARK_CONTEXTSWITCH_TIME == 1)
+	if(clock_gettime(CLOCK_MONOTONIC, &cst) != 0) {dexit("clock_gettime() failed");}
+	job->cst_clean_ns = cst.tv_sec*(1000000000) + cst.tv_nsec;
+	#endif
+	
+	//
+	//report back: finished or accelerator given back
+	//
+	#if(USS_FIFO == 1 || USS_SHM == 1)	
+	curr_message.address = job->my_addr;
+	curr_message.handle = job->handle;
+	curr_message.init_ns = init_ns;
+	curr_message.free_ns = free_ns;
+	curr_message.main_ns = main_ns;
+	curr_message.nof_main = nof_main;
+	#endif
+	curr_message.message_type = (*job->is_finished) ? USS_MESSAGE_ISFINISHED : USS_MESSAGE_CLEANUP_DONE;
+	curr_message.accelerator_type = type;
+	curr_message.accelerator_index = current_device_id;
+	ret = libuss_send_to_daemon(&job->my_addr, &job->daemon_addr, &curr_message, job->my_fd, job->daemon_fd);
+	if(ret != 0) {dexit("library could not send message!!");}
+	job->ret = ret;
+}
+
+/*
+ * cleanup by closing the file descriptors
+ */
+static void libuss_job_cleanup(struct uss_job *job)
+{
+#if(USS_SHARED_RUN_ON == 1)
+	runon_uninstall(job->run_on_slot, &job->my_addr, 1);
+#endif
+#if(USS_SHM == 1)
+	shm_uninstall(job->my_fd, 1);
+	shm_uninstall(job->daemon_fd, 0);
+#else
+	close(job->my_fd);
+	close(job->daemon_fd);
+#endif
+#if(USS_RTSIG == 1)
+	//give lid back to the multiplexer
+	libuss_clear_multi_table_index(job->my_addr.lid);
+#endif
+}
+
+/*
+ * libuss_start_registered
+ *
+ * provides main algorithm for a job registered with libuss_register_batch
+ */
+int libuss_start_registered(struct uss_registration *reg, void *md, void *mcp, int *is_finished, int *run_on, int *device_id)
+{
+	//the daemon may have been too busy for it so far
+	int ret = libuss_registration_wait(&reg);
+	if(ret != 0) {return ret;}
+	
+	struct uss_job job;
+	libuss_job_init(&job, reg, md, mcp, is_finished, run_on, device_id);
+	
+	//
+	//main functionality
+	//
+	//update once
+	update_run_on(job.run_on, job.device_id, job.my_fd, job.run_on_slot);
+	//loop
+	while (!(*job.is_finished))
+	{
+		libuss_job_step(&job);
+	}
+
+	libuss_job_cleanup(&job);
+	return job.ret;
+}
+
+
+//////////////////////////////////////////////
+//											//
+// submitted jobs							//
+//											//
+//////////////////////////////////////////////
+/*
+ * jobs submitted with libuss_submit do not get a thread of their own
+ * -> FIFO: a monitor thread waits on the channels of all IDLE jobs
+ *    (one epoll set) and hands a job the daemon has put on an
+ *    accelerator to the workers
+ * -> a worker runs the job as long as the daemon keeps it on an
+ *    accelerator and gives it back to the monitor once it is IDLE
+ * -> a worker is only created if none is free when a job gets ready
+ *    => the number of workers follows the jobs running at the same
+ *    time (one per device plus the ones on CPU) and not the number
+ *    of submitted ones
+ * -> jobs the daemon is too busy for are queued in order, the monitor
+ *    registers them again when a timerfd in its epoll set expires
+ *    (libuss_submit does not wait for it, one retry at a time keeps
+ *    many waiting jobs from asking the daemon over and over)
+ *
+ * COMMENT:
+ * the other transports can not wait on many jobs with one thread
+ * (SHM: a futex per ring, RTSIG: signals go to the registering thread)
+ * => there every submitted job is run by a thread of its own
+ */
+
+/*
+ * the job is done: release its channels and wake up libuss_wait
+ */
+static void libuss_job_done(struct uss_job *job)
+{
+	int ret;
+	ret = pthread_mutex_lock(&job->done_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+
+	__atomic_store_n(&job->done, 1, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&job->done_cond);
+
+	ret = pthread_mutex_unlock(&job->done_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+}
+
+#if(USS_FIFO == 1)
+/***************************************\
+* executor								*
+\***************************************/
+static pthread_mutex_t executor_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t executor_cond = PTHREAD_COND_INITIALIZER;
+static int executor_started = 0;
+static int executor_epoll_fd = -1;
+
+//jobs put on an accelerator, each one has a free worker reserved
+static std::deque<struct uss_job*> executor_ready;
+//waiting workers that have no job reserved
+static int executor_nof_free_workers = 0;
+//jobs the daemon has been too busy for (in order), the head waits on the timerfd
+static std::deque<struct uss_job*> executor_retry;
+static int executor_retry_fd = -1;
+static unsigned int executor_retry_seed = 0;
+
+static void* libuss_executor_worker(void *args);
+
+/*
+ * queue job for the workers (creates one if none is free)
+ */
+static void libuss_executor_ready(struct uss_job *job)
+{
+	int ret;
+	ret = pthread_mutex_lock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_lock");
+
+	executor_ready.push_back(job);
+	if(executor_nof_free_workers > 0)
+	{
+		executor_nof_free_workers--;
+		pthread_cond_signal(&executor_cond);
+	}
+	else
+	{
+		pthread_t worker;
+		ret = pthread_create(&worker, NULL, libuss_executor_worker, NULL);
+		if(ret != 0) dexit("libuss_executor: pthread_create");
+	}
+
+	ret = pthread_mutex_unlock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_unlock");
+}
+
+/*
+ * read the decisions sent over the channel of an IDLE job
+ * (the latest one counts, with a shared run_on it is in the slot)
+ * and hand the job to the workers or back to the monitor
+ */
+static void libuss_executor_dispatch(struct uss_job *job)
+{
+	struct uss_message m;
+	ssize_t nof_br;
+	while((nof_br = fifo_blocking_read(&m, job->my_fd)) == sizeof(struct uss_message))
+	{
+		#if(USS_SHARED_RUN_ON == 0)
+		*job->run_on = m.accelerator_type;
+		*job->device_id = m.accelerator_index;
+		#endif
+	}
+	if(nof_br == 0) {dexit("libuss_executor: daemon has crashed!");}
+	if(nof_br == -1 && errno != EAGAIN && errno != EINTR) {dexit("libuss_executor: read too small");}
+	#if(USS_SHARED_RUN_ON == 1)
+	runon_load(job->run_on_slot, job->run_on, job->device_id);
+	#endif
+
+	if(libuss_accel_runnable(*job->run_on))
+	{
+		libuss_executor_ready(job);
+	}
+	else
+	{
+		//one shot => the monitor hands it to exactly one worker
+		//(added only now: even without interest a hangup would be reported
+		// while a worker finishes the job)
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(struct epoll_event));
+		ev.events = EPOLLIN | EPOLLONESHOT;
+		ev.data.ptr = job;
+		int op = (job->in_monitor) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+		job->in_monitor = 1;
+		if(epoll_ctl(executor_epoll_fd, op, job->my_fd, &ev) == -1) {dexit("libuss_executor: epoll_ctl");}
+	}
+}
+
+/*
+ * arm the retry timer for the registration at the head of executor_retry
+ * (executor_mtx is held)
+ */
+static void libuss_executor_arm_retry(struct uss_registration *reg)
+{
+	int wait_ms = libuss_registration_delay(reg, &executor_retry_seed);
+	#if(USS_LIBRARY_DEBUG == 1)
+	printf("(daemon is busy, register again after %i ms)\n", wait_ms);
+	#endif
+	struct itimerspec its;
+	memset(&its, 0, sizeof(struct itimerspec));
+	its.it_value.tv_sec = wait_ms / 1000;
+	its.it_value.tv_nsec = (long)(wait_ms % 1000) * 1000000;
+	if(timerfd_settime(executor_retry_fd, 0, &its, NULL) == -1) {dexit("libuss_executor: timerfd_settime");}
+}
+
+/*
+ * the daemon has been too busy for reg: queue job behind the other ones
+ * (the monitor registers them again one after the other)
+ */
+static void libuss_executor_retry_later(struct uss_job *job, struct uss_registration *reg)
+{
+	int ret;
+	ret = pthread_mutex_lock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_lock");
+
+	job->reg = reg;
+	executor_retry.push_back(job);
+	if(executor_retry.size() == 1) {libuss_executor_arm_retry(reg);}
+
+	ret = pthread_mutex_unlock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_unlock");
+}
+
+/*
+ * take over an accepted registration and run the job
+ */
+static void libuss_executor_start(struct uss_job *job, struct uss_registration *reg)
+{
+	libuss_job_init(job, reg, job->md, job->mcp, job->is_finished, job->run_on, job->device_id);
+	#if(USS_SHARED_RUN_ON == 1)
+	//the monitor waits on the channel and not on the slot
+	runon_set_notify(job->run_on_slot);
+	#endif
+
+	//dispatch hands it to a worker (or to the monitor)
+	libuss_executor_dispatch(job);
+}
+
+/*
+ * the retry timer has expired: register the queued jobs again in order
+ * until the daemon is still too busy for one
+ * (by the monitor: a round trip to the daemon is short)
+ */
+static void libuss_executor_retry()
+{
+	int ret;
+	uint64_t expirations;
+	if(read(executor_retry_fd, &expirations, sizeof(uint64_t)) == -1 && errno != EAGAIN) {dexit("libuss_executor: read timerfd");}
+
+	while(1)
+	{
+		ret = pthread_mutex_lock(&executor_mtx);
+		if(ret != 0) dexit("thread_mutex_lock");
+		//(only the monitor takes jobs out of executor_retry)
+		struct uss_job *job = (executor_retry.empty()) ? NULL : executor_retry.front();
+		ret = pthread_mutex_unlock(&executor_mtx);
+		if(ret != 0) dexit("thread_mutex_unlock");
+		if(job == NULL) {break;}
+
+		struct meta_sched_info *msi = job->reg->msi;
+		struct uss_registration *reg;
+		int reg_ret = libuss_register_at(&msi, 1, &reg, job->reg->start_ns);
+		free(job->reg);
+		job->reg = (reg_ret == 0 && reg->retry_ms > 0) ? reg : NULL;
+
+		ret = pthread_mutex_lock(&executor_mtx);
+		if(ret != 0) dexit("thread_mutex_lock");
+		if(job->reg != NULL) {libuss_executor_arm_retry(job->reg);}
+		else {executor_retry.pop_front();}
+		ret = pthread_mutex_unlock(&executor_mtx);
+		if(ret != 0) dexit("thread_mutex_unlock");
+
+		if(job->reg != NULL) {break;}
+		if(reg_ret != 0)
+		{
+			job->ret = reg_ret;
+			libuss_job_done(job);
+		}
+		else
+		{
+			libuss_executor_start(job, reg);
+		}
+	}
+}
+
+/*
+ * runs the jobs the daemon has put on an accelerator
+ */
+static void* libuss_executor_worker(void *args)
+{
+	pthread_detach(pthread_self());
+	int ret;
+	struct uss_job *job;
+
+	ret = pthread_mutex_lock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_lock");
+	while(1)
+	{
+		while(executor_ready.empty()) {pthread_cond_wait(&executor_cond, &executor_mtx);}
+		job = executor_ready.front();
+		executor_ready.pop_front();
+
+		ret = pthread_mutex_unlock(&executor_mtx);
+		if(ret != 0) dexit("thread_mutex_unlock");
+
+		//run it as long as the daemon keeps it on an accelerator
+		while(libuss_accel_runnable(*job->run_on) && !(*job->is_finished))
+		{
+			libuss_job_step(job);
+		}
+		if(*job->is_finished)
+		{
+			if(job->in_monitor && epoll_ctl(executor_epoll_fd, EPOLL_CTL_DEL, job->my_fd, NULL) == -1) {dexit("libuss_executor: epoll_ctl");}
+			libuss_job_cleanup(job);
+			libuss_job_done(job);
+		}
+		else
+		{
+			libuss_executor_dispatch(job);
+		}
+
+		ret = pthread_mutex_lock(&executor_mtx);
+		if(ret != 0) dexit("thread_mutex_lock");
+		executor_nof_free_workers++;
+	}
+	return NULL;
+}
+
+/*
+ * waits on the channels of all IDLE jobs
+ */
+static void* libuss_executor_monitor(void *args)
+{
+	pthread_detach(pthread_self());
+	struct epoll_event events[USS_EXECUTOR_BATCH];
+	while(1)
+	{
+		int nof_events = epoll_wait(executor_epoll_fd, events, USS_EXECUTOR_BATCH, -1);
+		if(nof_events == -1 && errno == EINTR) {continue;}
+		if(nof_events == -1) {dexit("libuss_executor: epoll_wait");}
+
+		for(int i = 0; i < nof_events; i++)
+		{
+			//(the retry timer has no job)
+			if(events[i].data.ptr == NULL) {libuss_executor_retry();}
+			else {libuss_executor_dispatch((struct uss_job*)events[i].data.ptr);}
+		}
+	}
+	return NULL;
+}
+
+/*
+ * starts the monitor (only if not active yet)
+ */
+static void libuss_start_executor()
+{
+	int ret;
+	ret = pthread_mutex_lock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_lock");
+
+	if(executor_started == 0)
+	{
+		executor_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if(executor_epoll_fd == -1) {dexit("libuss_executor: epoll_create1");}
+
+		executor_retry_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		if(executor_retry_fd == -1) {dexit("libuss_executor: timerfd_create");}
+		executor_retry_seed = (unsigned int)(libuss_get_time_ns() ^ (uint64_t)getpid());
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(struct epoll_event));
+		ev.events = EPOLLIN;
+		ev.data.ptr = NULL;
+		if(epoll_ctl(executor_epoll_fd, EPOLL_CTL_ADD, executor_retry_fd, &ev) == -1) {dexit("libuss_executor: epoll_ctl");}
+
+		pthread_t monitor;
+		ret = pthread_create(&monitor, NULL, libuss_executor_monitor, NULL);
+		if(ret != 0) dexit("libuss_executor: pthread_create");
+		executor_started = 1;
+	}
+
+	ret = pthread_mutex_unlock(&executor_mtx);
+	if(ret != 0) dexit("thread_mutex_unlock");
+}
+
+#else
+/***************************************\
+* thread per job						*
+\***************************************/
+/*
+ * registers and runs a submitted job (like libuss_start)
+ */
+static void* libuss_job_thread(void *args)
+{
+	pthread_detach(pthread_self());
+	struct uss_job *job = (struct uss_job*)args;
+	struct uss_registration *reg;
+
+	job->ret = libuss_register_batch(&job->msi, 1, &reg);
+	if(job->ret == 0) {job->ret = libuss_registration_wait(&reg);}
+	if(job->ret == 0)
+	{
+		libuss_job_init(job, reg, job->md, job->mcp, job->is_finished, job->run_on, job->device_id);
+		update_run_on(job->run_on, job->device_id, job->my_fd, job->run_on_slot);
+		while(!(*job->is_finished))
+		{
+			libuss_job_step(job);
+		}
+		libuss_job_cleanup(job);
+	}
+	libuss_job_done(job);
+	return NULL;
+}
+#endif
+
+/***************************************\
+* api									*
+\***************************************/
+/*
+ * libuss_submit
+ *
+ * registers a job and returns at once, the job is run by the library
+ * -> the arguments are the ones of libuss_start
+ * -> its result is fetched (and the job released) with libuss_wait
+ * -> a job the daemon is too busy for is registered again by the
+ *    library (an error of that is returned by libuss_wait)
+ *
+ * returns job or NULL on error
+ */
+struct uss_job* libuss_submit(struct meta_sched_info *msi, void *md, void *mcp, int *is_finished, int *run_on, int *device_id)
+{
+	int ret;
+	struct uss_job *job = (struct uss_job*) malloc(sizeof(struct uss_job));
+	if(!job) {dexit("libuss_submit: malloc");}
+	memset(job, 0, sizeof(struct uss_job));
+
+	//(taken over from the registration once it is accepted, registered by
+	// its thread with the other transports, see libuss_job_thread)
+	job->msi = msi;
+	job->md = md;
+	job->mcp = mcp;
+	job->is_finished = is_finished;
+	job->run_on = run_on;
+	job->device_id = device_id;
+#if(USS_FIFO == 1)
+	struct uss_registration *reg;
+	ret = libuss_register_batch(&msi, 1, &reg);
+	if(ret != 0) {printf("registering at daemon unsuccessful -> quit\n"); free(job); return NULL;}
+#endif
+	if(pthread_mutex_init(&job->done_mutex, NULL) != 0) {dexit("libuss_submit: mutex init");}
+	if(pthread_cond_init(&job->done_cond, NULL) != 0) {dexit("libuss_submit: cond init");}
+
+#if(USS_FIFO == 1)
+	libuss_start_executor();
+	if(reg->retry_ms > 0) {libuss_executor_retry_later(job, reg);}
+	else {libuss_executor_start(job, reg);}
+#else
+	pthread_t thread;
+	ret = pthread_create(&thread, NULL, libuss_job_thread, job);
+	if(ret != 0) {dexit("libuss_submit: pthread_create");}
+#endif
+	return job;
+}
+
+/*
+ * libuss_poll
+ *
+ * returns 1 if job is done (libuss_wait returns at once), 0 otherwise
+ */
+int libuss_poll(struct uss_job *job)
+{
+	return __atomic_load_n(&job->done, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * libuss_wait
+ *
+ * waits until job is done and releases it
+ *
+ * returns what libuss_start would have returned
+ */
+int libuss_wait(struct uss_job *job)
+{
+	int ret;
+	ret = pthread_mutex_lock(&job->done_mutex);
+	if(ret != 0) dexit("thread_mutex_lock");
+
+	while(!job->done) {pthread_cond_wait(&job->done_cond, &job->done_mutex);}
+
+	ret = pthread_mutex_unlock(&job->done_mutex);
+	if(ret != 0) dexit("thread_mutex_unlock");
+
+	ret = job->ret;
+	pthread_mutex_destroy(&job->done_mutex);
+	pthread_cond_destroy(&job->done_cond);
+	free(job);
+	return ret;
+}
+
+
+//////////////////////////////////////////////
+//											//
+// helper for creating an msi				//
+//											//
+//////////////////////////////////////////////
+/*
+ * libuss_msi_insert
+ *
+ */
+int libuss_fill_msi(struct meta_sched_info *msi, int type, int affinity, int flags, 
+					int (*algo_init_function)(void*, void*, int), 
+					int (*algo_main_function)(void*, void*, int), 
+					int (*algo_free_function)(void*, void*, int))
+{
+	msi->ptr[type] = (struct meta_sched_info_element*) malloc(sizeof(struct meta_sched_info_element));
+	struct meta_sched_info_element *element = msi->ptr[type];
+	if(!element) {printf("Error with malloc\n"); return -1;}
+
+	element->affinity = affinity;
+	element->flags = flags;
+	element->init = algo_init_function;
+	element->main = algo_main_function;
+	element->free = algo_free_function;
+	
+	return 0;
+}
+
+int libuss_free_msi(struct meta_sched_info *msi)
+{
+	for(int f = 0; f<USS_NOF_SUPPORTED_ACCEL; f++)
+	{
+		if(msi->ptr[f] != NULL) {free(msi->ptr[f]);}
+	}
+	return 0;
+}
+
+/*
+ * libuss_set_nice
+ * returns -1 if nice is out of [USS_NICE_MIN, USS_NICE_MAX]
+ */
+int libuss_set_nice(struct meta_sched_info *msi, int nice)
+{
+	if(nice < USS_NICE_MIN || nice > USS_NICE_MAX) {return -1;}
+	msi->nice = nice;
+	return 0;
+}
+
+/*
+ * libuss_set_deadline
+ * returns -1 if deadline_ms is negative (0 removes the deadline)
+ */
+int libuss_set_deadline(struct meta_sched_info *msi, long deadline_ms)
+{
+	if(deadline_ms < 0) {return -1;}
+	msi->deadline_ms = deadline_ms;
+	return 0;
+}
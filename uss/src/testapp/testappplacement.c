@@ -0,0 +1,144 @@
+/*
+ * this is a testapplication for the initial placement of jobs
+ * (see benchmark/uss_benchmark_placement.sh)
+ */
+
+ /*
+  * CURRENT EXAMPLE
+  *
+  * a job of a class runs on CUDA, FPGA and/or STREAM
+  * -> it is as fast on a type as its affinity there says:
+  *    each call of main sleeps PLACEMENT_SLICE_US and does
+  *    <affinity> units of the PLACEMENT_WORK units of the job
+  * -> alone on a type of affinity 10 it needs PLACEMENT_WORK / 10 slices
+  *
+  */
+//basic
+#include <stdlib.h>
+#include <stdio.h>
+
+//string
+#include <string.h>
+#include <sys/types.h>
+
+//sleep
+#include <unistd.h>
+
+//USS
+#include "../library/uss.h"
+
+#include "../benchmark/dwatch.h"
+
+#define PLACEMENT_SLICE_US 10000
+#define PLACEMENT_WORK 1000
+
+/*
+ * classes of jobs: affinity on CUDA, FPGA, STREAM (0 = no implementation)
+ */
+#define PLACEMENT_NOF_CLASSES 3
+#define PLACEMENT_NOF_TYPES 3
+static const int placement_type[PLACEMENT_NOF_TYPES] = {USS_ACCEL_TYPE_CUDA, USS_ACCEL_TYPE_FPGA, USS_ACCEL_TYPE_STREAM};
+static const int placement_class[PLACEMENT_NOF_CLASSES][PLACEMENT_NOF_TYPES] =
+{
+	{10, 8, 6},	//runs well everywhere
+	{10, 3, 0},	//needs CUDA really
+	{4, 10, 2},	//best on FPGA
+};
+
+//////////////////////////////////////////////
+//											//
+// own user-defined USS structures			//
+//											//
+//////////////////////////////////////////////
+struct meta_data
+{
+	int cls;
+	int done;
+	int is_finished;
+};
+
+
+//////////////////////////////////////////////
+//											//
+// implementation (one main per type)		//
+//											//
+//////////////////////////////////////////////
+int placement_init(void *md_void, void *mcp_void, int device_id)
+{
+	return 0;
+}
+
+static int placement_main(void *md_void, int type_index)
+{
+	struct meta_data *md = (struct meta_data*) md_void;
+	usleep(PLACEMENT_SLICE_US);
+	md->done += placement_class[md->cls][type_index];
+	if(md->done >= PLACEMENT_WORK) {md->is_finished = 1;}
+	return 0;
+}
+
+int placement_main_cuda(void *md_void, void *mcp_void, int device_id) {return placement_main(md_void, 0);}
+int placement_main_fpga(void *md_void, void *mcp_void, int device_id) {return placement_main(md_void, 1);}
+int placement_main_stream(void *md_void, void *mcp_void, int device_id) {return placement_main(md_void, 2);}
+
+int placement_free(void *md_void, void *mcp_void, int device_id)
+{
+	return 0;
+}
+
+
+//////////////////////////////////////////////
+//											//
+// MAIN (fills msi and calls libuss_start)	//
+//											//
+//////////////////////////////////////////////
+int main(int argc, char *argv[])
+{
+	//
+	//parse input
+	//
+	if(argc != 3)
+	{
+		printf("syntax: testappplacement <id> <class 0..%i>\n", PLACEMENT_NOF_CLASSES - 1);
+		exit(-1);
+	}
+	int id = atoi(argv[1]);
+	int cls = atoi(argv[2]);
+	if(cls < 0 || cls >= PLACEMENT_NOF_CLASSES) {printf("bad class\n"); exit(-1);}
+
+	init_dwatch();
+
+	//
+	//fill meta_sched_info struct
+	//
+	struct meta_sched_info msi;
+	memset(&msi, 0, sizeof(struct meta_sched_info));
+
+	int (*placement_mains[PLACEMENT_NOF_TYPES])(void*, void*, int) = {&placement_main_cuda, &placement_main_fpga, &placement_main_stream};
+	for(int t = 0; t < PLACEMENT_NOF_TYPES; t++)
+	{
+		if(placement_class[cls][t] == 0) {continue;}
+		libuss_fill_msi(&msi, placement_type[t], placement_class[cls][t], 0, &placement_init, placement_mains[t], &placement_free);
+	}
+
+	//
+	//fill meta_data struct
+	//
+	struct meta_data md;
+	md.cls = cls;
+	md.done = 0;
+	md.is_finished = 0;
+
+	//
+	//now ready to call library function
+	//
+	int run_on;
+	int device_id;
+	int ret = libuss_start(&msi, (void*)&md, NULL, &(md.is_finished), &run_on, &device_id);
+	libuss_free_msi(&msi);
+	if(ret != 0) {printf("libuss_start failed with %i\n", ret); return -1;}
+
+	//returns id and total turnaround time in ms
+	printf("%i %lf\n", id, diff_dwatch());
+	return 0;
+}